@@ -0,0 +1,5 @@
+// Per-frame values shared by every program, see FrameUniforms in the sketches.
+layout(std140) uniform Frame
+{
+    mat4 projection;
+};
@@ -0,0 +1,16 @@
+#version 330
+
+// per vertex
+in vec2 vertex;
+
+// per instance
+in vec2 offset;
+in vec4 color;
+
+out vec4 vertexColor;
+
+void main()
+{
+    vertexColor = color;
+    gl_Position = vec4(vertex + offset, 0.0, 1.0);
+}
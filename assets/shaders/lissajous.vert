@@ -2,9 +2,14 @@
 
 in vec2 position;
 
-uniform mat4 projection;
+// the unprojected position, so lines fade with the same distance the CPU
+// uses to pick which vertices to join
+out vec2 vertexPosition;
+
+#include "frame.glsl"
 
 void main()
 {
+    vertexPosition = position;
     gl_Position = projection*vec4(position, 0.0, 1.0);
 }
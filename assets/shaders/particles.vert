@@ -0,0 +1,25 @@
+#version 330
+
+// Transform feedback version of particles.comp: move each particle by its
+// velocity, bouncing off the edges of clip space.
+in vec2 pos;
+in vec2 vel;
+
+out vec2 outPos;
+out vec2 outVel;
+
+uniform float dt;
+
+void main()
+{
+    outPos = pos + vel*dt;
+    outVel = vel;
+    if (abs(outPos.x) > 1.0)
+    {
+        outVel.x = -outVel.x;
+    }
+    if (abs(outPos.y) > 1.0)
+    {
+        outVel.y = -outVel.y;
+    }
+}
@@ -0,0 +1,12 @@
+#version 330
+
+in vec2 vertex;
+in vec4 color;
+
+out vec4 vertexColor;
+
+void main()
+{
+    vertexColor = color;
+    gl_Position = vec4(vertex, 0.0, 1.0);
+}
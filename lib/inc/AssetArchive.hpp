@@ -0,0 +1,108 @@
+#ifndef ASSET_ARCHIVE_HPP
+#define ASSET_ARCHIVE_HPP
+
+#include <AssetCache.hpp>
+#include <MappedFile.hpp>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace tetra
+{
+    /**
+     * The on-disk layout of an asset archive, as written by tools/packAssets.
+     *
+     *      Header
+     *      IndexEntry[entryCount]
+     *      names (namesSize bytes, not null terminated)
+     *      entries, each starting on an ALIGNMENT boundary
+     *
+     * Integers are in the byte order of the machine which packed the archive.
+     */
+    namespace archive
+    {
+        constexpr char MAGIC[4] = {'T', 'P', 'A', 'K'};
+        constexpr std::uint32_t VERSION = 1;
+        constexpr std::uint64_t ALIGNMENT = 64;
+
+        /** IndexEntry flag for entries stored as an LZ4 block */
+        constexpr std::uint32_t LZ4 = 1;
+
+        struct Header
+        {
+            char magic[4];
+            std::uint32_t version;
+            std::uint32_t entryCount;
+            std::uint32_t namesSize;
+        };
+
+        struct IndexEntry
+        {
+            std::uint64_t offset; /** from the start of the archive */
+            std::uint64_t storedSize; /** bytes in the archive */
+            std::uint64_t size; /** bytes once decompressed */
+            std::uint64_t hash; /** Fnv1a of the decompressed contents */
+            std::uint32_t nameOffset; /** into the names */
+            std::uint32_t nameLength;
+            std::uint32_t flags;
+            std::uint32_t reserved;
+        };
+
+        static_assert(sizeof(Header) == 16, "the header layout is fixed");
+        static_assert(sizeof(IndexEntry) == 48, "the index layout is fixed");
+    } /* namespace archive */
+
+    /**
+     * This class serves assets from a single archive file.
+     * The whole archive is mapped once, uncompressed entries are handed out as
+     * views straight into the mapping. LZ4 entries are decompressed the first
+     * time they are found and kept for the life of the archive.
+     *
+     * Normally used through AssetCache rather than directly.
+     */
+    class AssetArchive
+    {
+    public:
+        /**
+         * Map an archive and read its index.
+         * @throws FailedToLoadAsset if the file is missing, isn't an archive, or
+         *         has compressed entries and LZ4 support wasn't built in.
+         */
+        AssetArchive(const std::string& path);
+
+        /**
+         * Views point into the archive, so it cannot be copied.
+         */
+        AssetArchive(const AssetArchive&) = delete;
+
+        /**
+         * Find an asset by its path relative to the asset root,
+         * e.g. "shaders/identity.vert".
+         * @return the asset, or nullptr if the archive doesn't have it.
+         * @throws FailedToLoadAsset if a compressed entry is corrupt.
+         */
+        const AssetView* find(const std::string& path);
+
+        /**
+         * The number of assets in the archive.
+         */
+        int size() const;
+
+    private:
+        struct Entry
+        {
+            const archive::IndexEntry* index;
+            AssetView view; /** empty until a compressed entry is decompressed */
+            std::string decompressed;
+        };
+
+        const std::string path;
+        MappedFile file;
+        std::unordered_map<std::string, Entry> entries;
+
+        void decompress(const std::string& name, Entry& entry);
+    };
+} /* namespace tetra */
+
+#endif
@@ -0,0 +1,171 @@
+#ifndef ASSET_CACHE_HPP
+#define ASSET_CACHE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tetra
+{
+    class AssetArchive;
+    class MappedFile;
+
+    /**
+     * A non-owning view of an asset's contents and a hash of those contents.
+     * The hash is FNV-1a (see Fnv1a.hpp), so it is stable between runs and can
+     * key on-disk caches.
+     */
+    struct AssetView
+    {
+        std::string_view data;
+        std::uint64_t hash;
+    };
+
+    /**
+     * An owned copy of an asset's contents, which stays valid however the cache
+     * changes afterwards.
+     */
+    struct AssetCopy
+    {
+        std::string data;
+        std::uint64_t hash;
+    };
+
+    /**
+     * This class memory-maps files under an asset root and hands out views of
+     * them. Each file is mapped once no matter how many times it is loaded.
+     * If an asset archive is open, files are served from it instead, see
+     * AssetArchive.hpp. Once a file is invalidated it is read from the asset root
+     * from then on, so hot reloading works on top of an archive.
+     *
+     * Shaders get a small preprocessor. A line like
+     *      #include "frame.glsl"
+     * is replaced by that file from the shaders directory, followed by a #line
+     * directive so compile errors still point at the right line. Each file's
+     * expansion is cached, so an include shared by many shaders is expanded once.
+     * Shaders without includes are handed out straight from the mapping.
+     *
+     * Views stay valid until the file is invalidated or the cache is destroyed.
+     * Every method is safe to call from any thread, but a file must not be
+     * invalidated while another thread is still using a view of it.
+     */
+    class AssetCache
+    {
+    public:
+        /**
+         * Create a cache for the files under ASSET_ROOT, served from the archive
+         * at ASSET_ARCHIVE if CMake was configured with PACK_ASSETS and the
+         * archive has been built.
+         */
+        AssetCache();
+
+        /**
+         * Create a cache for the files under root.
+         * @param archive
+         *     the path of an asset archive to serve files from, or empty to always
+         *     read from root.
+         * @throws FailedToLoadAsset if the archive cannot be opened.
+         */
+        AssetCache(const std::string& root, const std::string& archive = "");
+
+        /**
+         * Views point into the cache, so it cannot be copied.
+         */
+        AssetCache(const AssetCache&) = delete;
+
+        /**
+         * Unmap every file.
+         */
+        ~AssetCache();
+
+        /**
+         * Get a file's contents, mapping it on the first load.
+         * @param path The path relative to the root, e.g. "shaders/identity.vert"
+         * @throws FailedToLoadAsset if the file cannot be opened or mapped.
+         */
+        AssetView load(const std::string& path);
+
+        /**
+         * Get a shader's source with every #include expanded.
+         * @param name The name (not path) of a file in the shaders directory.
+         * @throws FailedToLoadAsset if a file is missing or includes itself.
+         */
+        AssetView shader(const std::string& name);
+
+        /**
+         * Copy a file's contents, see load().
+         * The copy is made while the cache is locked, so unlike a view it is safe
+         * to take on one thread while another may invalidate the file.
+         * @throws FailedToLoadAsset if the file cannot be opened or mapped.
+         */
+        AssetCopy copy(const std::string& path);
+
+        /**
+         * Copy a shader's expanded source, see shader() and copy().
+         * @throws FailedToLoadAsset if a file is missing or includes itself.
+         */
+        AssetCopy copyShader(const std::string& name);
+
+        /**
+         * The names of every shader file the expansion of name pulled in,
+         * directly or through other includes.
+         * Returned by value, as another thread may invalidate the expansion.
+         */
+        std::vector<std::string> includes(const std::string& name);
+
+        /**
+         * Forget a file so the next load reads it again. Expanded shaders which
+         * included it are forgotten too.
+         * Views of the file from earlier loads are no longer valid. Call this as
+         * soon as a file changes, reading a mapping of a file which has been
+         * truncated on disk can crash.
+         * @param path The path relative to the root, e.g. "shaders/frame.glsl"
+         */
+        void invalidate(const std::string& path);
+
+        /**
+         * The number of loose files currently mapped, not counting the archive.
+         */
+        int mappedFiles() const;
+
+    private:
+        struct LoadedFile
+        {
+            std::unique_ptr<MappedFile> file; /** null if served from the archive */
+            AssetView view;
+        };
+
+        struct ExpandedShader
+        {
+            std::string source; /** empty if the shader has no includes */
+            AssetView view;
+            std::vector<std::string> includes;
+        };
+
+        const std::string root;
+        /** Recursive because expanding a shader loads its includes */
+        mutable std::recursive_mutex lock;
+        std::unique_ptr<AssetArchive> archive;
+        std::unordered_set<std::string> loose;
+        std::unordered_map<std::string, LoadedFile> files;
+        std::unordered_map<std::string, ExpandedShader> shaders;
+
+        /**
+         * Expand a shader's includes, using stack to detect include cycles.
+         */
+        const ExpandedShader& expand(const std::string& name,
+                                     std::vector<std::string>& stack);
+    };
+
+    /**
+     * The cache used by loadShaderSrc.
+     */
+    AssetCache& assetCache();
+} /* namespace tetra */
+
+#endif
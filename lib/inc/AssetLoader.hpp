@@ -0,0 +1,100 @@
+#ifndef ASSET_LOADER_HPP
+#define ASSET_LOADER_HPP
+
+#include <AssetCache.hpp>
+#include <tetra/EventStream.hpp>
+#include <tetra/ThreadPool.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace tetra
+{
+    /**
+     * This event is fired when an asset requested from an AssetLoader is ready.
+     * The contents are copied out of the AssetCache on the worker thread, so the
+     * event stays valid if the file is invalidated before it is dispatched.
+     */
+    struct AssetLoaded
+    {
+        std::string path; /** e.g. "shaders/lissajous.vert" */
+        std::string data;
+        std::uint64_t hash; /** see AssetView */
+    };
+
+    /**
+     * This event is fired when an asset requested from an AssetLoader could not
+     * be loaded.
+     */
+    struct AssetFailed
+    {
+        std::string path;
+        std::string reason;
+    };
+
+    /**
+     * This class loads assets on a pool of worker threads, so reading,
+     * decompressing and preprocessing never block the render thread.
+     * Each request ends with an AssetLoaded or AssetFailed event in the stream.
+     * GL work with the result, like compiling or uploading, belongs on the render
+     * thread, see FrameBudget.
+     *
+     * EXAMPLE:
+     *      auto loader = AssetLoader{eventStream};
+     *      loader.loadShader("lissajous.vert");
+     *      // a later dispatch() delivers
+     *      //   AssetLoaded{"shaders/lissajous.vert", source, hash}
+     */
+    class AssetLoader
+    {
+    public:
+        /**
+         * Create a loader which loads through cache on its own worker threads.
+         * The cache must outlive the loader.
+         */
+        AssetLoader(EventStream& eventStream,
+                    AssetCache& cache = assetCache(),
+                    int threads = 2);
+
+        /**
+         * Workers refer to the loader, so it cannot be copied.
+         */
+        AssetLoader(const AssetLoader&) = delete;
+
+        /**
+         * Drop the requests which haven't started and wait for the rest.
+         */
+        ~AssetLoader();
+
+        /**
+         * Load a file, see AssetCache::load.
+         */
+        void load(const std::string& path);
+
+        /**
+         * Load a shader with its includes expanded, see AssetCache::shader.
+         * The event's path is "shaders/" + name.
+         */
+        void loadShader(const std::string& name);
+
+        /**
+         * The number of requests which haven't pushed their event yet.
+         */
+        int pending() const;
+
+    private:
+        EventStream& eventStream;
+        AssetCache& cache;
+        std::atomic<int> _pending;
+        ThreadPool workers; // last, so workers stop before the rest is destroyed
+
+        /**
+         * Run a load on a worker and push the event for the result.
+         */
+        template <class Load>
+        void submit(const std::string& path, Load load);
+    };
+} /* namespace tetra */
+
+#endif
@@ -8,6 +8,8 @@ namespace tetra
     /**
      * Load the shader source code from the asset directory.
      * By convention shader source code is located in the ASSET_ROOT/shaders directory.
+     * Files are read through assetCache(), so each is mapped once and #include
+     * directives are expanded.
      * @param name The name (not path) of the shader file.
      * @return The shader's source code as a string
      */
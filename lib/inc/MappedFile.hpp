@@ -0,0 +1,46 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace tetra
+{
+    /**
+     * This class owns a read-only private memory mapping of a whole file.
+     */
+    class MappedFile
+    {
+    public:
+        /**
+         * Map a file.
+         * @param name The asset name, used in error messages.
+         * @param path The full path to the file.
+         * @throws FailedToLoadAsset if the file cannot be opened or mapped.
+         */
+        MappedFile(const std::string& name, const std::string& path);
+
+        /**
+         * Mappings cannot be copied.
+         */
+        MappedFile(const MappedFile&) = delete;
+
+        /**
+         * Unmap the file.
+         */
+        ~MappedFile();
+
+        /**
+         * The contents of the file. Empty files are not mapped and give an empty
+         * view.
+         */
+        std::string_view data() const;
+
+    private:
+        void* address;
+        std::size_t size;
+    };
+} /* namespace tetra */
+
+#endif
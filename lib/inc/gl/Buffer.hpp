@@ -2,11 +2,15 @@
 #define BUFFER_HPP
 
 #include <gl/GLException.hpp>
+#include <gl/GLState.hpp>
 
 #include <GL/glew.h>
 
 #include <vector>
 #include <memory>
+#include <iterator>
+#include <string>
+#include <algorithm>
 
 namespace tetra
 {
@@ -115,10 +119,65 @@ namespace tetra
 
         template <>
         GLenum elementType<GLuint>();
+
+        /**
+         * Block until the GL signals the fence, then delete it.
+         * @throws GLException if waiting on the fence fails.
+         */
+        void waitAndDeleteFence(GLsync fence);
     }
 
+    // Fwd declare, defined below
+    template <class Data>
+    class AsyncRead;
+
+    /**
+     * This class tracks which element ranges of a buffer have been modified since
+     * they were last uploaded.
+     * Overlapping and adjacent ranges are merged as they are marked, so a flush
+     * issues as few uploads as possible.
+     */
+    class DirtyRanges
+    {
+    public:
+        /** A half-open range of element indices [first, last) */
+        struct Range
+        {
+            int first;
+            int last;
+        };
+
+        /**
+         * Mark count elements, starting at first, as modified.
+         */
+        void mark(int first, int count = 1);
+
+        /**
+         * True if nothing has been marked since the last clear().
+         */
+        bool empty() const;
+
+        /**
+         * The merged dirty ranges, sorted by first element.
+         */
+        const std::vector<Range>& ranges() const;
+
+        /**
+         * Forget every dirty range.
+         */
+        void clear();
+
+    private:
+        std::vector<Range> _ranges;
+    };
+
     /**
      * This class represents an OpenGL Buffer.
+     * The GL store is allocated with room to grow: capacity() may be larger than
+     * size(), and writes which fit within the capacity update the existing store
+     * in place instead of reallocating it.
+     * When the current GLState has directStateAccess() enabled the buffer is
+     * written and read with the glNamedBuffer* calls and is never bound.
      */
     template <class Data>
     class Buffer
@@ -131,6 +190,8 @@ namespace tetra
             : target{target}
             , shouldDelete{true}
             , _size{0}
+            , _capacity{0}
+            , usage{UsageHint::StreamDraw}
         {
             glCreateBuffers(1, &handle);
         }
@@ -142,6 +203,7 @@ namespace tetra
         {
             if (shouldDelete)
             {
+                GLState::current().forgetBuffer(handle);
                 glDeleteBuffers(1, &handle);
                 shouldDelete = false;
             }
@@ -160,10 +222,14 @@ namespace tetra
             , handle{from.handle}
             , target{from.target}
             , _size{from._size}
+            , _capacity{from._capacity}
+            , usage{from.usage}
+            , dirty{std::move(from.dirty)}
         {
             // don't let the other guy delete our buffer when he goes out of scope!
             from.shouldDelete = false;
             from._size = 0;
+            from._capacity = 0;
         }
 
         /**
@@ -176,10 +242,11 @@ namespace tetra
 
         /**
          * Bind the buffer to the last target it was bound to.
+         * Does nothing if the buffer is already bound there.
          */
         void bind()
         {
-            glBindBuffer(target, handle);
+            GLState::current().bindBuffer(target, handle);
         }
 
         /**
@@ -190,41 +257,199 @@ namespace tetra
             return handle;
         }
 
+        /**
+         * Bind the whole buffer to an indexed shader storage binding point, so
+         * shaders can read and write it as a `layout(std430, binding = N) buffer`.
+         * The buffer keeps its own target, so a vertex buffer can be filled by
+         * a compute shader and then drawn. Requires GL 4.3.
+         */
+        void bindStorage(GLuint binding)
+        {
+            GLState::current().bindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, handle);
+            THROW_ON_GL_ERROR();
+        }
+
+        /**
+         * Bind count elements starting at element first to a shader storage
+         * binding point. The byte offset must be a multiple of
+         * GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT.
+         */
+        void bindStorage(GLuint binding, int first, int count)
+        {
+            GLState::current().bindBufferRange(
+                GL_SHADER_STORAGE_BUFFER, binding, handle,
+                sizeof(Data) * first, sizeof(Data) * count
+            );
+            THROW_ON_GL_ERROR();
+        }
+
         /**
          * Write data into the GL buffer.
+         * If the data fits in the current capacity and the usage is unchanged then
+         * the existing store is updated in place. Data which doesn't fit
+         * reallocates with room to grow, and a new usage reallocates at the
+         * current capacity.
          * Automatically bind the buffer to it's last bound target.
          */
         void write(const std::vector<Data>& data,
                    UsageHint usage = UsageHint::StreamDraw)
         {
-            bind();
-            auto byteSize = data.size() * sizeof(Data);
-            glBufferData(target, byteSize, data.data(), usage);
-            THROW_ON_GL_ERROR();
-            this->_size = data.size();
+            const int count = data.size();
+            if (count > _capacity)
+            {
+                allocate(std::max(count, 2*_capacity), usage);
+            }
+            else if (usage != this->usage)
+            {
+                // only growth doubles, a new hint keeps the current capacity
+                allocate(_capacity, usage);
+            }
+            this->_size = count;
+            upload(0, data.data(), count);
+            dirty.clear();
+        }
+
+        /**
+         * Make sure the GL store can hold at least capacity elements without
+         * reallocating. Existing contents are discarded if the store grows.
+         */
+        void reserve(int capacity, UsageHint usage = UsageHint::StreamDraw)
+        {
+            if (capacity > _capacity || usage != this->usage)
+            {
+                allocate(std::max(capacity, _capacity), usage);
+            }
         }
 
         /**
-         * Read data out of the GL buffer.
+         * Overwrite count elements starting at element offset without reallocating.
+         * The size grows if the update extends past the end of the current data.
+         * Automatically bind the buffer to it's last bound target.
+         * @throws GLException if offset + count is greater than capacity()
+         */
+        void update(int offset, const Data* data, int count)
+        {
+            if (offset < 0 || offset + count > _capacity)
+            {
+                throw GLException{ "Buffer update of elements"
+                                 , std::to_string(offset)
+                                 , "to"
+                                 , std::to_string(offset + count)
+                                 , "is outside of the buffer's capacity"
+                                 , std::to_string(_capacity)
+                                 };
+            }
+            upload(offset, data, count);
+            this->_size = std::max(_size, offset + count);
+        }
+
+        /**
+         * Overwrite the elements starting at element offset with the contiguous
+         * range [first, last) -- e.g. a slice of a std::vector or std::array.
+         */
+        template <class ContiguousIter>
+        void update(int offset, ContiguousIter first, ContiguousIter last)
+        {
+            if (first == last)
+            {
+                return;
+            }
+            update(offset, &*first, std::distance(first, last));
+        }
+
+        /**
+         * Mark count elements starting at first as modified.
+         * The next flush() will upload them.
+         */
+        void markDirty(int first, int count = 1)
+        {
+            dirty.mark(first, count);
+        }
+
+        /**
+         * Upload every range marked dirty since the last write() or flush() from
+         * source, which must hold the same elements as the buffer.
+         * Only the modified elements are transferred.
+         */
+        void flush(const std::vector<Data>& source)
+        {
+            for (const auto& range : dirty.ranges())
+            {
+                update(range.first, source.data() + range.first,
+                       range.last - range.first);
+            }
+            dirty.clear();
+        }
+
+        /**
+         * Read size elements, starting at element offset, out of the GL buffer
+         * directly into out, which must have room for them.
          * The data is undefined if the Data type does not match what is stored in
          * the buffer.
          * Automatically bind the buffer to it's last bound target.
-         * Note to self -- currently this _always_ performs 2 heap allocations.
-         * This can definitely be reduced with a better API or some clever caching.
          * @throws GLException
          *     if sizeof(Data)*offset + sizeof(Data)*size is greater
          *     than the size of the GL buffer
          */
-        std::vector<Data> read(int size, int offset = 0)
+        void read(Data* out, int size, int offset = 0)
         {
-            bind();
-            auto byteOffset = offset * sizeof(Data);
-            auto byteSize = size * sizeof(Data);
-            auto data = std::unique_ptr<Data[]>{new Data[byteSize]};
-            glGetBufferSubData(target, byteOffset, byteSize, data.get());
+            const auto byteOffset = offset * sizeof(Data);
+            const auto byteSize = size * sizeof(Data);
+            if (GLState::current().directStateAccess())
+            {
+                glGetNamedBufferSubData(handle, byteOffset, byteSize, out);
+            }
+            else
+            {
+                bind();
+                glGetBufferSubData(target, byteOffset, byteSize, out);
+            }
             THROW_ON_GL_ERROR();
+        }
 
-            return std::vector<Data>(data.get(), data.get()+byteSize);
+        /**
+         * Read size elements into out, resizing it to fit.
+         * Reusing the same vector across reads avoids any heap allocation once it
+         * has grown large enough.
+         */
+        void read(std::vector<Data>& out, int size, int offset = 0)
+        {
+            out.resize(size);
+            read(out.data(), size, offset);
+        }
+
+        /**
+         * Read size elements into a new vector.
+         */
+        std::vector<Data> read(int size, int offset = 0)
+        {
+            auto data = std::vector<Data>(size);
+            read(data.data(), size, offset);
+            return data;
+        }
+
+        /**
+         * Start reading size elements without waiting for the GL.
+         * The elements are copied to a staging buffer on the GL timeline and can be
+         * fetched from the returned AsyncRead once it is ready(), so the pipeline
+         * does not stall on readback.
+         * Each call creates and deletes its own staging buffer, use the overload
+         * below to reuse one for repeated reads.
+         */
+        AsyncRead<Data> readAsync(int size, int offset = 0) const
+        {
+            return AsyncRead<Data>{*this, size, offset};
+        }
+
+        /**
+         * Start reading size elements into a caller-owned staging buffer, which
+         * only reallocates if it is too small.
+         * The staging buffer must outlive the read and not be reused until it
+         * has been fetched with get().
+         */
+        AsyncRead<Data> readAsync(Buffer<Data>& staging, int size, int offset = 0) const
+        {
+            return AsyncRead<Data>{*this, staging, size, offset};
         }
 
         /**
@@ -235,6 +460,15 @@ namespace tetra
             return _size;
         }
 
+        /**
+         * Return's the number of elements the GL buffer can hold before it must
+         * be reallocated.
+         */
+        int capacity() const
+        {
+            return _capacity;
+        }
+
         /**
          * Draw's the contents of the buffer using the provided primitive.
          */
@@ -246,18 +480,266 @@ namespace tetra
 
         /**
          * Draw's the contents of the vao using the element buffer.
+         * Each index is offset by baseVertex before fetching the vertex, which is
+         * how streamed vertices (see StreamingBuffer::offset()) are drawn.
          */
-        void drawElements(Primitive primitive)
+        void drawElements(Primitive primitive, int baseVertex = 0)
         {
-            glDrawElements(GL_LINES, size(), hidden::elementType<Data>(), 0);
+            glDrawElementsBaseVertex(
+                primitive, size(), hidden::elementType<Data>(), 0, baseVertex
+            );
+            THROW_ON_GL_ERROR();
+        }
+
+        /**
+         * Draw the contents of the buffer once per instance.
+         * Per-instance attributes advance by one element every divisor instances,
+         * starting at baseInstance (GL 4.2 or ARB_base_instance if non-zero).
+         */
+        void drawInstanced(Primitive primitive, int instances, int baseInstance = 0)
+        {
+            if (baseInstance == 0)
+            {
+                glDrawArraysInstanced(primitive, 0, size(), instances);
+            }
+            else
+            {
+                glDrawArraysInstancedBaseInstance(
+                    primitive, 0, size(), instances, baseInstance
+                );
+            }
+            THROW_ON_GL_ERROR();
+        }
+
+        /**
+         * Draw the contents of the vao using the element buffer, once per
+         * instance. See drawElements and drawInstanced.
+         */
+        void drawElementsInstanced(Primitive primitive,
+                                   int instances,
+                                   int baseVertex = 0,
+                                   int baseInstance = 0)
+        {
+            if (baseInstance == 0)
+            {
+                glDrawElementsInstancedBaseVertex(
+                    primitive, size(), hidden::elementType<Data>(), 0,
+                    instances, baseVertex
+                );
+            }
+            else
+            {
+                glDrawElementsInstancedBaseVertexBaseInstance(
+                    primitive, size(), hidden::elementType<Data>(), 0,
+                    instances, baseVertex, baseInstance
+                );
+            }
             THROW_ON_GL_ERROR();
         }
 
     private:
         int _size;
+        int _capacity;
+        UsageHint usage;
+        DirtyRanges dirty;
         BindTarget target;
         bool shouldDelete;
         GLuint handle;
+
+        /**
+         * Reallocate the GL store with room for capacity elements.
+         */
+        void allocate(int capacity, UsageHint usage)
+        {
+            const auto byteSize = capacity * sizeof(Data);
+            if (GLState::current().directStateAccess())
+            {
+                glNamedBufferData(handle, byteSize, nullptr, usage);
+            }
+            else
+            {
+                bind();
+                glBufferData(target, byteSize, nullptr, usage);
+            }
+            THROW_ON_GL_ERROR();
+            this->_capacity = capacity;
+            this->usage = usage;
+        }
+
+        /**
+         * Copy count elements into the store at element offset.
+         */
+        void upload(int offset, const Data* data, int count)
+        {
+            const auto byteOffset = offset * sizeof(Data);
+            const auto byteSize = count * sizeof(Data);
+            if (GLState::current().directStateAccess())
+            {
+                glNamedBufferSubData(handle, byteOffset, byteSize, data);
+            }
+            else
+            {
+                bind();
+                glBufferSubData(target, byteOffset, byteSize, data);
+            }
+            THROW_ON_GL_ERROR();
+        }
+    };
+
+    /**
+     * This class represents a readback from a Buffer which is still in flight.
+     * The source range is copied into a staging buffer followed by a fence, and
+     * the results are fetched from the staging buffer once the fence signals.
+     * The staging buffer is either owned by the read, or borrowed from the caller
+     * so repeated reads don't create and delete a GL buffer each time.
+     *
+     * EXAMPLE:
+     *      auto pending = buffer.readAsync(buffer.size());
+     *      ... render the next frame ...
+     *      if (pending.ready())
+     *      {
+     *          pending.get(results);
+     *      }
+     */
+    template <class Data>
+    class AsyncRead
+    {
+    public:
+        /**
+         * Copy size elements, starting at element offset, out of source into a
+         * new staging buffer.
+         */
+        AsyncRead(const Buffer<Data>& source, int size, int offset = 0)
+            : owned{new Buffer<Data>{BindTarget::CopyWrite}}
+            , staging{owned.get()}
+            , _size{size}
+        {
+            copy(source, offset);
+        }
+
+        /**
+         * Copy size elements, starting at element offset, out of source into a
+         * borrowed staging buffer.
+         */
+        AsyncRead(const Buffer<Data>& source, Buffer<Data>& staging, int size, int offset = 0)
+            : staging{&staging}
+            , _size{size}
+        {
+            copy(source, offset);
+        }
+
+        /**
+         * Async reads cannot be copied.
+         */
+        AsyncRead(const AsyncRead&) = delete;
+
+        /**
+         * Transfer ownership of the staging buffer and fence.
+         */
+        AsyncRead(AsyncRead&& from)
+            : owned{std::move(from.owned)}
+            , staging{from.staging}
+            , fence{from.fence}
+            , _size{from._size}
+        {
+            from.fence = nullptr;
+        }
+
+        /**
+         * Delete the fence if it's still outstanding.
+         */
+        ~AsyncRead()
+        {
+            if (fence != nullptr)
+            {
+                glDeleteSync(fence);
+            }
+        }
+
+        /**
+         * True once the copy has completed and get() will not block.
+         * @throws GLException if waiting on the fence fails, instead of never
+         *         becoming ready.
+         */
+        bool ready()
+        {
+            if (fence == nullptr)
+            {
+                return true;
+            }
+
+            auto result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+            if (result == GL_TIMEOUT_EXPIRED)
+            {
+                return false;
+            }
+
+            glDeleteSync(fence);
+            fence = nullptr;
+            if (result == GL_WAIT_FAILED)
+            {
+                THROW_ON_GL_ERROR();
+                throw GLException{"glClientWaitSync failed while polling an async read"};
+            }
+            return true;
+        }
+
+        /**
+         * Copy the results into out, which must have room for size() elements.
+         * Blocks until the copy has completed if it isn't ready() yet.
+         */
+        void get(Data* out)
+        {
+            if (fence != nullptr)
+            {
+                hidden::waitAndDeleteFence(fence);
+                fence = nullptr;
+            }
+            staging->read(out, _size);
+        }
+
+        /**
+         * Copy the results into out, resizing it to fit.
+         */
+        void get(std::vector<Data>& out)
+        {
+            out.resize(_size);
+            get(out.data());
+        }
+
+        /**
+         * The number of elements being read.
+         */
+        int size() const
+        {
+            return _size;
+        }
+
+    private:
+        std::unique_ptr<Buffer<Data>> owned;
+        Buffer<Data>* staging;
+        GLsync fence;
+        int _size;
+
+        void copy(const Buffer<Data>& source, int offset)
+        {
+            staging->reserve(_size, UsageHint::StreamRead);
+            auto& state = GLState::current();
+            if (state.directStateAccess())
+            {
+                glCopyNamedBufferSubData(source.raw(), staging->raw(),
+                                         offset * sizeof(Data), 0, _size * sizeof(Data));
+            }
+            else
+            {
+                state.bindBuffer(GL_COPY_READ_BUFFER, source.raw());
+                state.bindBuffer(GL_COPY_WRITE_BUFFER, staging->raw());
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                    offset * sizeof(Data), 0, _size * sizeof(Data));
+            }
+            THROW_ON_GL_ERROR();
+            fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
     };
 } /* namespace tetra */
 
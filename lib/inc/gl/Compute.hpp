@@ -0,0 +1,85 @@
+#ifndef COMPUTE_HPP
+#define COMPUTE_HPP
+
+#include <gl/Buffer.hpp>
+#include <gl/Program.hpp>
+
+#include <GL/glew.h>
+
+#include <array>
+
+namespace tetra
+{
+    /**
+     * The record glDispatchComputeIndirect reads: the number of work groups in
+     * each dimension. A compute shader can write these to size a later dispatch
+     * without a round trip through the CPU.
+     */
+    struct DispatchIndirectCommand
+    {
+        GLuint groupsX;
+        GLuint groupsY;
+        GLuint groupsZ;
+    };
+
+    /**
+     * The kinds of access which must see a shader's incoherent writes (shader
+     * storage, images, atomic counters). OR them together for memoryBarrier().
+     * Each bit names how the data will be read next, not how it was written.
+     */
+    enum Barrier : GLbitfield
+    {
+        /** Drawing with vertex attributes sourced from the buffer */
+        VertexAttribArrayBarrier = GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT,
+        /** Drawing with indices sourced from the buffer */
+        ElementArrayBarrier = GL_ELEMENT_ARRAY_BARRIER_BIT,
+        /** Reading the buffer as a uniform block */
+        UniformBarrier = GL_UNIFORM_BARRIER_BIT,
+        /** Indirect draw or dispatch commands sourced from the buffer */
+        CommandBarrier = GL_COMMAND_BARRIER_BIT,
+        /** Buffer reads, writes and copies through the API, e.g. Buffer::read */
+        BufferUpdateBarrier = GL_BUFFER_UPDATE_BARRIER_BIT,
+        /** Shader storage reads and writes in a later dispatch or draw */
+        ShaderStorageBarrier = GL_SHADER_STORAGE_BARRIER_BIT,
+        AllBarriers = GL_ALL_BARRIER_BITS
+    };
+
+    /**
+     * Order a dispatch's writes before the accesses named by barriers.
+     *
+     * EXAMPLE:
+     *      dispatch(update, groups);
+     *      memoryBarrier(VertexAttribArrayBarrier | ShaderStorageBarrier);
+     *      particles.draw(Primitive::Points);
+     */
+    void memoryBarrier(GLbitfield barriers);
+
+    /**
+     * The local work group size the compute program was linked with.
+     */
+    std::array<GLint, 3> workGroupSize(Program& program);
+
+    /**
+     * The number of groups of groupSize needed to cover count invocations.
+     * The shader must ignore the invocations past count in the last group.
+     */
+    GLuint groupsFor(int count, GLint groupSize);
+
+    /**
+     * Use the compute program and run groupsX * groupsY * groupsZ work groups.
+     * @throws GLException if the program isn't a compute program or the count
+     *         exceeds GL_MAX_COMPUTE_WORK_GROUP_COUNT.
+     */
+    void dispatch(Program& program, GLuint groupsX, GLuint groupsY = 1, GLuint groupsZ = 1);
+
+    /**
+     * Use the compute program and run the work groups given by the command'th
+     * record of commands, which is bound to the dispatch indirect target.
+     * If the GPU wrote the record, issue memoryBarrier(CommandBarrier) first.
+     */
+    void dispatchIndirect(Program& program,
+                          const Buffer<DispatchIndirectCommand>& commands,
+                          int command = 0);
+} /* namespace tetra */
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef FEEDBACK_LOOP_HPP
+#define FEEDBACK_LOOP_HPP
+
+#include <gl/Buffer.hpp>
+#include <gl/GLException.hpp>
+#include <gl/GLState.hpp>
+#include <gl/Program.hpp>
+#include <gl/VAO.hpp>
+#include <gl/VertexLayout.hpp>
+
+#include <GL/glew.h>
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace tetra
+{
+    /**
+     * This class keeps simulation state on the GL and advances it with a vertex
+     * shader, using transform feedback to ping-pong between two buffers.
+     * Each step() draws the current buffer as points with rasterization
+     * disabled, and captures the shader's outputs into the other buffer, which
+     * then becomes current. Nothing is uploaded after the initial write().
+     *
+     * The update program must be linked with feedbackVaryings() naming outputs
+     * that line up, in order and size, with the members of State. Its vertex
+     * attributes are the members described by layout.
+     *
+     * EXAMPLE:
+     *      // GLSL: in vec2 pos; in vec2 vel; out vec2 outPos; out vec2 outVel;
+     *      auto update = ProgramLinker{}
+     *          .vertexAttributes({"pos", "vel"})
+     *          .feedbackVaryings({"outPos", "outVel"})
+     *          .source(ShaderType::VERTEX, loadShaderSrc("particles.vert"))
+     *          .link();
+     *      auto particles = FeedbackLoop<Particle>{particleLayout};
+     *      particles.write(initial);
+     *      // each frame
+     *      particles.step(update);
+     *      draw.use();
+     *      particles.draw(Primitive::Points);
+     *
+     * Works with GL 3.3: only the default transform feedback object is used.
+     */
+    template <class State>
+    class FeedbackLoop
+    {
+    public:
+        /**
+         * Create both buffers and the vaos which read State from them.
+         */
+        template <std::size_t N>
+        FeedbackLoop(const std::array<VertexAttrib, N>& layout)
+            : vaos{}
+            , buffers{{ AttribBinder<State>{vaos[0]}.layout(layout).bind()
+                      , AttribBinder<State>{vaos[1]}.layout(layout).bind()
+                     }}
+            , current{0}
+            , _size{0}
+            , validated{0}
+        { }
+
+        /**
+         * Replace the simulation state. This is the only upload.
+         */
+        void write(const std::vector<State>& state)
+        {
+            _size = state.size();
+            buffers[current].write(state, UsageHint::DynamicCopy);
+            buffers[1 - current].reserve(_size, UsageHint::DynamicCopy);
+        }
+
+        /**
+         * Run program over every element of the current state and make its
+         * captured outputs the new current state.
+         * The captured varyings are checked against State the first time each
+         * linked program is stepped.
+         * @throws GLException if the program's captured varyings don't add up to
+         *         sizeof(State), e.g. it isn't linked with feedback varyings.
+         */
+        void step(Program& program)
+        {
+            if (program.raw() != validated)
+            {
+                const int stride = program.feedbackStride();
+                if (stride != (int)sizeof(State))
+                {
+                    throw GLException{ "FeedbackLoop program captures"
+                                     , std::to_string(stride)
+                                     , "bytes per element but State is"
+                                     , std::to_string(sizeof(State))
+                                     };
+                }
+                validated = program.raw();
+            }
+
+            auto& state = GLState::current();
+            vaos[current].bind();
+            program.use();
+            state.bindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, buffers[1 - current].raw());
+
+            glEnable(GL_RASTERIZER_DISCARD);
+            glBeginTransformFeedback(GL_POINTS);
+            glDrawArrays(GL_POINTS, 0, _size);
+            glEndTransformFeedback();
+            glDisable(GL_RASTERIZER_DISCARD);
+            THROW_ON_GL_ERROR();
+
+            current = 1 - current;
+        }
+
+        /**
+         * Draw the current state with whichever program is in use.
+         */
+        void draw(Primitive primitive)
+        {
+            vaos[current].bind();
+            glDrawArrays(primitive, 0, _size);
+            THROW_ON_GL_ERROR();
+        }
+
+        /**
+         * Copy the current state back from the GL, e.g. to check it.
+         * This stalls until every step has finished.
+         */
+        std::vector<State> read()
+        {
+            return buffers[current].read(_size);
+        }
+
+        /**
+         * The vao which reads the current state, to draw it some other way.
+         * This changes after every step().
+         */
+        const Vao& vao() const
+        {
+            return vaos[current];
+        }
+
+        /**
+         * The number of elements in the state.
+         */
+        int size() const
+        {
+            return _size;
+        }
+
+    private:
+        std::array<Vao, 2> vaos;
+        std::array<Buffer<State>, 2> buffers;
+        int current;
+        int _size;
+        /** The last program checked against State, 0 for none */
+        GLuint validated;
+    };
+} /* namespace tetra */
+
+#endif
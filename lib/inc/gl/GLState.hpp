@@ -0,0 +1,165 @@
+#ifndef GLSTATE_HPP
+#define GLSTATE_HPP
+
+#include <GL/glew.h>
+
+#include <array>
+#include <unordered_map>
+
+namespace tetra
+{
+    /**
+     * This class holds the per-context configuration and bound-object cache which
+     * the gl wrappers consult before talking to the driver.
+     * A GLContext owns one GLState and makes it current when it is built, so
+     * wrappers can find it through GLState::current().
+     *
+     * Binds, program switches, blend changes and viewport changes which would not
+     * change anything are dropped. If you make raw GL calls which change any of
+     * the tracked state, call invalidate() afterwards so the cache doesn't lie.
+     */
+    class GLState
+    {
+    public:
+        /**
+         * How many tracked calls were issued to the driver and how many were
+         * dropped because they would not have changed anything.
+         */
+        struct Counters
+        {
+            long issued = 0;
+            long elided = 0;
+        };
+
+        /**
+         * Create the state for a context.
+         * @param directStateAccess
+         *     true if the wrappers should use the DSA (glNamed*, glVertexArray*)
+         *     entry points instead of binding objects to edit them.
+         * @param parallelShaderCompile
+         *     true if the driver compiles shaders on background threads and can be
+         *     polled with GL_COMPLETION_STATUS (KHR/ARB_parallel_shader_compile).
+         */
+        GLState(bool directStateAccess, bool parallelShaderCompile = false);
+
+        /**
+         * GL state is tied to a context, so it cannot be copied.
+         */
+        GLState(const GLState&) = delete;
+
+        /**
+         * Stop being the current state if this is the current state.
+         */
+        ~GLState();
+
+        /**
+         * True if objects should be edited with DSA calls instead of binds.
+         */
+        bool directStateAccess() const;
+
+        /**
+         * True if shader compiles and program links can be polled for completion
+         * without blocking.
+         */
+        bool parallelShaderCompile() const;
+
+        /**
+         * glBindVertexArray, unless the vao is already bound.
+         */
+        void bindVertexArray(GLuint vao);
+
+        /**
+         * glUseProgram, unless the program is already in use.
+         */
+        void useProgram(GLuint program);
+
+        /**
+         * glBindBuffer, unless the buffer is already bound to the target.
+         */
+        void bindBuffer(GLenum target, GLuint buffer);
+
+        /**
+         * glBindBufferBase. This also binds the buffer to the generic target, so
+         * the cache is updated to match.
+         */
+        void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+        /**
+         * glBindBufferRange. Like bindBufferBase this also updates the generic
+         * target.
+         */
+        void bindBufferRange(GLenum target, GLuint index, GLuint buffer,
+                             GLintptr offset, GLsizeiptr size);
+
+        /**
+         * glEnable/glDisable(GL_BLEND), unless blending is already in that state.
+         */
+        void blend(bool enabled);
+
+        /**
+         * glBlendFunc, unless the blend function is already set.
+         */
+        void blendFunc(GLenum source, GLenum destination);
+
+        /**
+         * glViewport, unless the viewport already matches.
+         */
+        void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+        /**
+         * Forget a deleted object so a new object which reuses its name is bound.
+         */
+        void forgetVertexArray(GLuint vao);
+        void forgetProgram(GLuint program);
+        void forgetBuffer(GLuint buffer);
+
+        /**
+         * Forget everything, so the next call of each kind goes to the driver.
+         */
+        void invalidate();
+
+        /**
+         * The counters since the last resetCounters().
+         * SDLWindow::Frame resets them at the start of every frame.
+         */
+        const Counters& counters() const;
+
+        /**
+         * Zero the counters.
+         */
+        void resetCounters();
+
+        /**
+         * Make this the state used by the gl wrappers.
+         */
+        void makeCurrent();
+
+        /**
+         * The state for the current context.
+         * If no context has been built yet this is a default state with every
+         * optional feature disabled.
+         */
+        static GLState& current();
+
+    private:
+        /** Tristate for cached flags which haven't been observed yet */
+        enum class Flag { Unknown, Disabled, Enabled };
+
+        const bool _directStateAccess;
+        const bool _parallelShaderCompile;
+        GLuint vertexArray;
+        GLuint program;
+        std::unordered_map<GLenum, GLuint> buffers;
+        Flag blending;
+        std::array<GLenum, 2> blendFunction;
+        std::array<GLint, 4> _viewport;
+        Counters _counters;
+
+        /**
+         * Count the call and return true if it needs to be issued.
+         */
+        bool changed(bool isDifferent);
+    };
+} /* namespace tetra */
+
+#endif
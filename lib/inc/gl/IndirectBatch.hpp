@@ -0,0 +1,252 @@
+#ifndef INDIRECT_BATCH_HPP
+#define INDIRECT_BATCH_HPP
+
+#include <gl/Buffer.hpp>
+#include <gl/GLException.hpp>
+#include <gl/VAO.hpp>
+
+#include <GL/glew.h>
+
+#include <iterator>
+#include <vector>
+
+namespace tetra
+{
+    /**
+     * The record glMultiDrawArraysIndirect reads for each draw.
+     */
+    struct DrawArraysIndirectCommand
+    {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint first;
+        GLuint baseInstance;
+    };
+
+    /**
+     * The record glMultiDrawElementsIndirect reads for each draw.
+     */
+    struct DrawElementsIndirectCommand
+    {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+
+    /**
+     * A mesh's place in a batch's shared buffers.
+     */
+    struct BatchedMesh
+    {
+        int firstVertex;
+        int vertexCount;
+        int firstIndex; /** always 0 for non-indexed batches */
+        int indexCount;
+    };
+
+    /**
+     * This class packs many meshes with the same vertex format into one vertex
+     * buffer (and one index buffer if Index isn't void) behind a single vao, and
+     * draws any selection of them with one glMultiDraw*Indirect call.
+     * Meshes are added once, then each frame draw() queues the meshes to render
+     * and submit() issues them all.
+     *
+     * EXAMPLE:
+     *      auto vao = Vao{};
+     *      auto batch = IndirectBatch<Vertex, GLuint>{
+     *          vao, AttribBinder<Vertex>{vao}.attrib(&Vertex::pos)
+     *      };
+     *      auto square = batch.add(squareVertices, squareIndices);
+     *      // each frame
+     *      batch.draw(square);
+     *      batch.submit(Primitive::Triangles);
+     *
+     * Requires GL 4.3 or ARB_multi_draw_indirect.
+     */
+    template <class Vertex, class Index = void>
+    class IndirectBatch
+    {
+    public:
+        /**
+         * Create a batch whose vertices are described by binder.
+         * The vao must outlive the batch.
+         */
+        IndirectBatch(Vao& vao, AttribBinder<Vertex> binder)
+            : vao{vao}
+            , vertexBuffer{binder.bind()}
+            , indexBuffer{BindTarget::ElementArray}
+            , commandBuffer{BindTarget::DrawIndirect}
+            , uploaded{true}
+        {
+            vao.elementBuffer(indexBuffer);
+        }
+
+        /**
+         * Append an indexed mesh. Indices are relative to the mesh's own vertices.
+         */
+        BatchedMesh add(const std::vector<Vertex>& meshVertices,
+                        const std::vector<Index>& meshIndices)
+        {
+            auto mesh = BatchedMesh{ (int)vertices.size(), (int)meshVertices.size()
+                                   , (int)indices.size(), (int)meshIndices.size()
+                                   };
+            vertices.insert(std::end(vertices), std::begin(meshVertices), std::end(meshVertices));
+            indices.insert(std::end(indices), std::begin(meshIndices), std::end(meshIndices));
+            uploaded = false;
+            return mesh;
+        }
+
+        /**
+         * Queue a mesh for the next submit().
+         */
+        void draw(const BatchedMesh& mesh, int instances = 1, int baseInstance = 0)
+        {
+            commands.push_back({ (GLuint)mesh.indexCount
+                               , (GLuint)instances
+                               , (GLuint)mesh.firstIndex
+                               , mesh.firstVertex
+                               , (GLuint)baseInstance
+                               });
+        }
+
+        /**
+         * Draw every queued mesh with one call and clear the queue.
+         * The batch's vao is bound, the caller chooses the program.
+         */
+        void submit(Primitive primitive)
+        {
+            // without DSA, uploading indices binds them to the bound vao
+            vao.bind();
+            upload();
+            if (commands.empty())
+            {
+                return;
+            }
+
+            commandBuffer.write(commands);
+            commandBuffer.bind();
+            glMultiDrawElementsIndirect(
+                primitive, hidden::elementType<Index>(), nullptr, commands.size(), 0
+            );
+            THROW_ON_GL_ERROR();
+            commands.clear();
+        }
+
+        /**
+         * The number of meshes queued for the next submit().
+         */
+        int queued() const
+        {
+            return commands.size();
+        }
+
+    private:
+        Vao& vao;
+        Buffer<Vertex> vertexBuffer;
+        Buffer<Index> indexBuffer;
+        Buffer<DrawElementsIndirectCommand> commandBuffer;
+        std::vector<Vertex> vertices;
+        std::vector<Index> indices;
+        std::vector<DrawElementsIndirectCommand> commands;
+        bool uploaded;
+
+        /**
+         * Copy meshes added since the last submit to the GL.
+         */
+        void upload()
+        {
+            if (!uploaded)
+            {
+                vertexBuffer.write(vertices, UsageHint::StaticDraw);
+                indexBuffer.write(indices, UsageHint::StaticDraw);
+                uploaded = true;
+            }
+        }
+    };
+
+    /**
+     * An IndirectBatch of non-indexed meshes, drawn with glMultiDrawArraysIndirect.
+     */
+    template <class Vertex>
+    class IndirectBatch<Vertex, void>
+    {
+    public:
+        /**
+         * Create a batch whose vertices are described by binder.
+         * The vao must outlive the batch.
+         */
+        IndirectBatch(Vao& vao, AttribBinder<Vertex> binder)
+            : vao{vao}
+            , vertexBuffer{binder.bind()}
+            , commandBuffer{BindTarget::DrawIndirect}
+            , uploaded{true}
+        { }
+
+        /**
+         * Append a mesh.
+         */
+        BatchedMesh add(const std::vector<Vertex>& meshVertices)
+        {
+            auto mesh = BatchedMesh{(int)vertices.size(), (int)meshVertices.size(), 0, 0};
+            vertices.insert(std::end(vertices), std::begin(meshVertices), std::end(meshVertices));
+            uploaded = false;
+            return mesh;
+        }
+
+        /**
+         * Queue a mesh for the next submit().
+         */
+        void draw(const BatchedMesh& mesh, int instances = 1, int baseInstance = 0)
+        {
+            commands.push_back({ (GLuint)mesh.vertexCount
+                               , (GLuint)instances
+                               , (GLuint)mesh.firstVertex
+                               , (GLuint)baseInstance
+                               });
+        }
+
+        /**
+         * Draw every queued mesh with one call and clear the queue.
+         * The batch's vao is bound, the caller chooses the program.
+         */
+        void submit(Primitive primitive)
+        {
+            if (!uploaded)
+            {
+                vertexBuffer.write(vertices, UsageHint::StaticDraw);
+                uploaded = true;
+            }
+            if (commands.empty())
+            {
+                return;
+            }
+
+            vao.bind();
+            commandBuffer.write(commands);
+            commandBuffer.bind();
+            glMultiDrawArraysIndirect(primitive, nullptr, commands.size(), 0);
+            THROW_ON_GL_ERROR();
+            commands.clear();
+        }
+
+        /**
+         * The number of meshes queued for the next submit().
+         */
+        int queued() const
+        {
+            return commands.size();
+        }
+
+    private:
+        Vao& vao;
+        Buffer<Vertex> vertexBuffer;
+        Buffer<DrawArraysIndirectCommand> commandBuffer;
+        std::vector<Vertex> vertices;
+        std::vector<DrawArraysIndirectCommand> commands;
+        bool uploaded;
+    };
+} /* namespace tetra */
+
+#endif
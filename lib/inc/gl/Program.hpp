@@ -2,6 +2,7 @@
 #define PROGRAM_HPP
 
 #include <gl/Shader.hpp>
+#include <gl/ProgramCache.hpp>
 
 #include <GL/glew.h>
 #include <glm/mat4x4.hpp>
@@ -9,6 +10,7 @@
 #include <array>
 #include <vector>
 #include <string>
+#include <unordered_map>
 
 namespace tetra
 {
@@ -19,6 +21,16 @@ namespace tetra
          */
         void uniformValue(GLint location, float f);
 
+        /**
+         * Set the value of a scalar int uniform.
+         */
+        void uniformValue(GLint location, int i);
+
+        /**
+         * Set the value of a scalar unsigned int uniform.
+         */
+        void uniformValue(GLint location, unsigned int u);
+
         /**
          * Set the value of a 1-element float vector.
          */
@@ -45,6 +57,71 @@ namespace tetra
         void uniformValue(GLint location, const glm::mat4& mat);
     }
 
+    /**
+     * This class is a typed handle to a uniform in a linked Program.
+     * It remembers the last value it uploaded and skips the glUniform* call when
+     * set() is called with the same value again.
+     * Like Program::uniform, set() applies to the program which is in use, and the
+     * cache only knows about values uploaded through this handle.
+     * A handle belongs to one linked GL program. When a ProgramLibrary rebuilds
+     * the program its location and cached value are stale, so fetch handles
+     * again in the library's setup callback or on ProgramReloaded.
+     *
+     * EXAMPLE:
+     *      auto projection = program.uniformHandle<glm::mat4>("projection");
+     *      // each frame
+     *      program.use();
+     *      projection.set(ortho.value()); // no GL call if unchanged
+     */
+    template <class T>
+    class UniformHandle
+    {
+    public:
+        /**
+         * Create a handle for the uniform at location.
+         */
+        UniformHandle(GLint location = -1)
+            : _location{location}
+            , uploaded{false}
+            , last{}
+        { }
+
+        /**
+         * Upload the value unless it matches the last uploaded value.
+         */
+        void set(const T& value)
+        {
+            if (uploaded && last == value)
+            {
+                return;
+            }
+            tetra::uniforms::uniformValue(_location, value);
+            last = value;
+            uploaded = true;
+        }
+
+        /**
+         * Forget the last uploaded value so the next set() always uploads.
+         */
+        void invalidate()
+        {
+            uploaded = false;
+        }
+
+        /**
+         * The uniform's location, -1 if the program has no such active uniform.
+         */
+        GLint location() const
+        {
+            return _location;
+        }
+
+    private:
+        GLint _location;
+        bool uploaded;
+        T last;
+    };
+
     /**
      * This class represents an OpenGL Program object.
      */
@@ -66,6 +143,12 @@ namespace tetra
          */
         Program(Program&& from);
 
+        /**
+         * Replace this program with another, deleting the one this held.
+         * Uniform locations from the old program are not valid for the new one.
+         */
+        Program& operator=(Program&& from);
+
         /**
          * Delete the shader program.
          */
@@ -78,14 +161,35 @@ namespace tetra
 
         /**
          * Use this program for the next OpenGL draw.
+         * Does nothing if the program is already in use.
          */
         void use();
 
         /**
          * Lookup a uniform location in the program.
-         * Effectively just calls glGetUniformLocation.
+         * Active uniforms are introspected once when the program is linked. Other
+         * names, such as array elements past the first or struct members, are
+         * looked up with glGetUniformLocation the first time and then cached.
+         * @return the location, or -1 if there is no active uniform with that name
+         */
+        GLint uniformLocation(const std::string& uniform) const;
+
+        /**
+         * The bytes transform feedback captures per vertex when the varyings are
+         * interleaved into one buffer, 0 if the program captures nothing.
+         * This queries the linked program every call.
+         * @throws GLException if a varying has a type this doesn't know the size of.
          */
-        GLint uniformLocation(const std::string& uniform);
+        int feedbackStride();
+
+        /**
+         * Get a typed handle to a uniform which skips redundant uploads.
+         */
+        template <class UType>
+        UniformHandle<UType> uniformHandle(const std::string& uniform) const
+        {
+            return UniformHandle<UType>{uniformLocation(uniform)};
+        }
 
         /**
          * Set a uniform in the program.
@@ -101,6 +205,73 @@ namespace tetra
     private:
         bool shouldDelete;
         GLuint handle;
+        /** Uniform locations by name, filled in on lookup for names not introspected */
+        mutable std::unordered_map<std::string, GLint> uniforms;
+
+        /**
+         * Record the location of every active uniform.
+         * Must be called after a successful link.
+         */
+        void introspectUniforms();
+
+        friend class ProgramLinker;
+        friend class PendingProgram;
+    };
+
+    /**
+     * This class is a handle to a program which has been submitted to the driver
+     * but may still be compiling and linking.
+     * Drivers with KHR/ARB_parallel_shader_compile do the work on their own
+     * threads, so submit every program first and then collect them with get().
+     *
+     * EXAMPLE:
+     *      auto pending = vector<PendingProgram>{};
+     *      for (auto& linker : linkers)
+     *      {
+     *          pending.push_back(linker.submit());
+     *      }
+     *      // ... do other loading while the driver compiles ...
+     *      for (auto& program : pending)
+     *      {
+     *          programs.push_back(program.get());
+     *      }
+     */
+    class PendingProgram
+    {
+    public:
+        /**
+         * Pending programs own the program and shaders, so they cannot be copied.
+         */
+        PendingProgram(const PendingProgram&) = delete;
+
+        /**
+         * Transfer ownership of the in-flight program and shaders.
+         */
+        PendingProgram(PendingProgram&&) = default;
+
+        /**
+         * True once the driver has finished compiling and linking, so get() won't
+         * block. Always true if the driver doesn't support parallel compiles.
+         */
+        bool ready();
+
+        /**
+         * Wait for the program to finish linking and take ownership of it.
+         * Can only be called once.
+         * @throws GLException if there is a compile or link error.
+         */
+        Program get();
+
+    private:
+        PendingProgram(Program&& program);
+
+        Program program;
+        std::vector<Shader> shaders;
+        ProgramCache* cache = nullptr;
+        std::string key;
+        bool linked = false;
+
+        friend class ProgramLinker;
     };
 
     /**
@@ -120,22 +291,67 @@ namespace tetra
          */
         ProgramLinker& vertexAttributes(const std::vector<std::string>& attribs);
 
+        /**
+         * Capture these vertex shader outputs with transform feedback, interleaved
+         * into a single buffer in the order given.
+         * This calls glTransformFeedbackVaryings before linking, see
+         * FeedbackLoop.hpp.
+         */
+        ProgramLinker& feedbackVaryings(const std::vector<std::string>& varyings);
+
         /**
          * Tell the builder to attach the shader to the program before linking.
          * References to the shaders will remain alive until link() is called.
          */
         ProgramLinker& attach(Shader& shader);
 
+        /**
+         * Tell the builder to compile a shader from source and attach it before
+         * linking. Unlike attach(), the source is only compiled if the program
+         * isn't found in the cache.
+         */
+        ProgramLinker& source(ShaderType type, const std::string& source);
+
+        /**
+         * Look the program up in the cache before compiling, and store it there
+         * after a successful link.
+         * Only programs built entirely from source() can be cached, because the
+         * sources are part of the key.
+         * The cache must stay alive until link() is called.
+         */
+        ProgramLinker& cache(ProgramCache& cache);
+
+        /**
+         * Start compiling and linking without waiting for the driver.
+         * Shaders passed to attach() must already be compiled, and they are only
+         * checked when the result is collected.
+         * If a cached binary is available and accepted by the driver then nothing
+         * is compiled and the returned program is immediately ready.
+         */
+        PendingProgram submit();
+
         /**
          * Link the shaders and vertex attributes to create the Program.
-         * @throws GLException if there is a link error.
+         * This is submit().get(), so it waits for the driver.
+         * @throws GLException if there is a compile or link error.
          */
         Program link();
 
     private:
         std::vector<std::string> _vertexAttributes;
+        std::vector<std::string> _feedbackVaryings;
         std::vector<Shader*> _shaders;
+        ProgramCache::Sources _sources;
+        ProgramCache* _cache = nullptr;
     };
+
+    /**
+     * Submit every linker before waiting on any of them, so drivers with compiler
+     * threads can build the programs in parallel.
+     * @return the programs in the same order as the linkers
+     * @throws GLException if any program has a compile or link error.
+     */
+    std::vector<Program> linkAll(std::vector<ProgramLinker>& linkers);
 } /* namespace tetra */
 
 #endif
@@ -0,0 +1,78 @@
+#ifndef PROGRAM_CACHE_HPP
+#define PROGRAM_CACHE_HPP
+
+#include <gl/Shader.hpp>
+
+#include <GL/glew.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tetra
+{
+    /**
+     * This class stores linked program binaries on disk so later runs can skip
+     * compiling and linking GLSL.
+     * Binaries are keyed by a hash of every shader source and type, the vertex
+     * attribute bindings, and the GL vendor/renderer/version strings, so a driver
+     * update or a shader edit simply misses the cache.
+     *
+     * Use it through ProgramLinker::cache(), see Program.hpp.
+     */
+    class ProgramCache
+    {
+    public:
+        using Sources = std::vector<std::pair<ShaderType, std::string>>;
+
+        /**
+         * Create a cache which keeps binaries in an existing directory.
+         * By default this is PROGRAM_CACHE_ROOT, which CMake creates in the build
+         * directory.
+         */
+        ProgramCache(const std::string& directory = defaultDirectory());
+
+        /**
+         * Compute the cache key for a program built from these inputs.
+         * Requires a current GL context for the driver strings.
+         */
+        std::string key(const Sources& sources,
+                        const std::vector<std::string>& attributes) const;
+
+        /**
+         * Whether the driver supports any program binary format. Drivers may
+         * report none, in which case load() always misses and store() does
+         * nothing. Queried once, and requires a current GL context.
+         */
+        bool enabled() const;
+
+        /**
+         * Try to load the binary stored under key into program.
+         * @return true if the driver accepted the binary and the program is linked,
+         *         false if there was no binary or the driver rejected it.
+         */
+        bool load(GLuint program, const std::string& key) const;
+
+        /**
+         * Store the binary of a linked program under key.
+         * Failures are ignored, a missed store just means a slower next start.
+         * The program should have been linked with
+         * GL_PROGRAM_BINARY_RETRIEVABLE_HINT set.
+         */
+        void store(GLuint program, const std::string& key) const;
+
+        /**
+         * The directory configured at build time for program binaries.
+         */
+        static std::string defaultDirectory();
+
+    private:
+        std::string directory;
+        /** GL_NUM_PROGRAM_BINARY_FORMATS, or -1 until enabled() asks for it */
+        mutable GLint formats = -1;
+
+        std::string path(const std::string& key) const;
+    };
+} /* namespace tetra */
+
+#endif
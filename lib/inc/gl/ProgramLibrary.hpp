@@ -0,0 +1,116 @@
+#ifndef PROGRAM_LIBRARY_HPP
+#define PROGRAM_LIBRARY_HPP
+
+#include <gl/Program.hpp>
+#include <gl/ProgramCache.hpp>
+#include <tetra/AssetWatcher.hpp>
+#include <tetra/EventStream.hpp>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tetra
+{
+    /**
+     * This event is fired after a ProgramLibrary swaps in a rebuilt program.
+     * The Program object is the same one add() returned, but it has a new GL
+     * program inside, so any uniform locations or UniformHandles taken from it
+     * must be looked up again.
+     */
+    struct ProgramReloaded
+    {
+        Program* program;
+    };
+
+    /**
+     * This class builds programs from shader files and rebuilds them when the
+     * files change.
+     * It listens for AssetChanged events from an AssetWatcher on "shaders" and
+     * only rebuilds the programs which use the changed file, either directly or
+     * through an #include, so a save costs one compile and link per affected
+     * program no matter how many other programs the sketch has. If the
+     * rebuild fails the error is printed and the previous program keeps working.
+     *
+     * EXAMPLE:
+     *      auto watcher = AssetWatcher{eventStream, "shaders"};
+     *      auto library = ProgramLibrary{eventStream};
+     *      Program& program = library.add(
+     *          {"vertex"},
+     *          { {ShaderType::VERTEX, "identity.vert"}
+     *          , {ShaderType::FRAGMENT, "identity.frag"}
+     *          });
+     */
+    class ProgramLibrary
+    {
+    public:
+        using ShaderFiles = std::vector<std::pair<ShaderType, std::string>>;
+
+        /**
+         * Called with each newly built program before it replaces the old one,
+         * e.g. to attach uniform blocks or to fetch UniformHandles again, since
+         * handles from the old program don't carry over. Throwing keeps the old
+         * program.
+         */
+        using Setup = std::function<void(Program&)>;
+
+        /**
+         * Create an empty library which rebuilds programs as AssetChanged events
+         * are dispatched.
+         * @param cache
+         *     if set, programs are built through the program binary cache.
+         *     It must outlive the library.
+         */
+        ProgramLibrary(EventStream& eventStream, ProgramCache* cache = nullptr);
+
+        /**
+         * Listeners refer to the library, so it cannot be copied.
+         */
+        ProgramLibrary(const ProgramLibrary&) = delete;
+
+        /**
+         * Build a program from files in ASSET_ROOT/shaders and keep it up to date.
+         * The returned reference stays valid for the life of the library.
+         * @throws GLException or FailedToLoadAsset if the first build fails.
+         */
+        Program& add(const std::vector<std::string>& vertexAttributes,
+                     const ShaderFiles& shaderFiles,
+                     Setup setup = Setup{});
+
+        /**
+         * Rebuild every program which uses the changed shader file.
+         */
+        void onAssetChanged(const AssetChanged& changed);
+
+    private:
+        struct Entry
+        {
+            std::vector<std::string> vertexAttributes;
+            ShaderFiles shaderFiles;
+            Setup setup;
+            Program program;
+        };
+
+        EventStream& eventStream;
+        ProgramCache* cache;
+        std::vector<std::unique_ptr<Entry>> entries;
+        std::unordered_map<std::string, std::vector<Entry*>> dependents;
+        EventStream::AutoRemoveListener listener;
+
+        /**
+         * Record that entry depends on each of its shader files and their includes.
+         */
+        void addDependencies(Entry* entry);
+
+        /**
+         * Load the shader files and build a program from them.
+         */
+        Program build(const std::vector<std::string>& vertexAttributes,
+                      const ShaderFiles& shaderFiles);
+    };
+} /* namespace tetra */
+
+#endif
@@ -0,0 +1,144 @@
+#ifndef PROXIMITY_LINES_HPP
+#define PROXIMITY_LINES_HPP
+
+#include <gl/Buffer.hpp>
+#include <gl/Program.hpp>
+#include <gl/StreamingBuffer.hpp>
+#include <gl/VAO.hpp>
+#include <tetra/ProximityGrid.hpp>
+
+#include <GL/glew.h>
+
+#include <array>
+#include <limits>
+#include <vector>
+
+namespace tetra
+{
+    /**
+     * This class draws a line between every pair of vertices closer than a
+     * cutoff distance, e.g. the lissajous cobweb.
+     * Pairs are found with a ProximityGrid each time the vertices change, so the
+     * cost grows with the number of lines drawn rather than with every possible
+     * pair. Indices are 16 bit while the vertices fit and 32 bit beyond that.
+     *
+     * EXAMPLE:
+     *      auto lines = ProximityLines<Vertex>{program, &Vertex::pos, 10000, 0.1f};
+     *      // each frame
+     *      lines.setVertices(vertices);
+     *      lines.render();
+     *
+     * Requires GL 4.4 or ARB_buffer_storage, see StreamingBuffer.
+     */
+    template <class Vertex>
+    class ProximityLines
+    {
+    public:
+        using Position = std::array<float, 2> Vertex::*;
+
+        /**
+         * Create a renderer whose program reads position as attribute 0.
+         * The program must outlive the renderer.
+         */
+        ProximityLines(Program& program, Position position, int maxVertices, float cutoff)
+            : program{program}
+            , position{position}
+            , vao{}
+            , vertexBuffer{AttribBinder<Vertex>{vao}.attrib(position).bind(), maxVertices}
+            , shortIndices{BindTarget::ElementArray}
+            , intIndices{BindTarget::ElementArray}
+            , wideIndices{false}
+            , cutoff{cutoff}
+        {
+            vao.elementBuffer(shortIndices);
+        }
+
+        ProximityLines(const ProximityLines&) = delete;
+        ProximityLines(ProximityLines&&) = default;
+
+        /**
+         * Upload new vertices and rebuild the lines between them.
+         * @throws GLException if there are more than maxVertices vertices.
+         */
+        void setVertices(const std::vector<Vertex>& vertices)
+        {
+            vertexBuffer.write(vertices);
+            grid.build(vertices, position, cutoff);
+
+            const bool wide = vertices.size() > (std::size_t)std::numeric_limits<GLushort>::max() + 1;
+            if (wide)
+            {
+                grid.pairs(intPairs);
+                intIndices.write(intPairs);
+            }
+            else
+            {
+                grid.pairs(shortPairs);
+                shortIndices.write(shortPairs);
+            }
+
+            if (wide != wideIndices)
+            {
+                wideIndices = wide;
+                if (wide)
+                {
+                    vao.elementBuffer(intIndices);
+                }
+                else
+                {
+                    vao.elementBuffer(shortIndices);
+                }
+            }
+        }
+
+        /**
+         * Change the distance under which vertices are joined.
+         * Takes effect at the next setVertices().
+         */
+        void setCutoff(float cutoff)
+        {
+            this->cutoff = cutoff;
+        }
+
+        /**
+         * Draw the lines from the last setVertices().
+         */
+        void render()
+        {
+            vao.bind();
+            program.use();
+            if (wideIndices)
+            {
+                intIndices.drawElements(Primitive::Lines, vertexBuffer.offset());
+            }
+            else
+            {
+                shortIndices.drawElements(Primitive::Lines, vertexBuffer.offset());
+            }
+            vertexBuffer.fence();
+        }
+
+        /**
+         * The number of lines drawn by render().
+         */
+        int lines() const
+        {
+            return (wideIndices ? intPairs.size() : shortPairs.size()) / 2;
+        }
+
+    private:
+        Program& program;
+        Position position;
+        Vao vao;
+        StreamingBuffer<Vertex> vertexBuffer;
+        Buffer<GLushort> shortIndices;
+        Buffer<GLuint> intIndices;
+        std::vector<GLushort> shortPairs;
+        std::vector<GLuint> intPairs;
+        ProximityGrid grid;
+        bool wideIndices;
+        float cutoff;
+    };
+} /* namespace tetra */
+
+#endif
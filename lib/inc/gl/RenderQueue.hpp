@@ -0,0 +1,166 @@
+#ifndef RENDER_QUEUE_HPP
+#define RENDER_QUEUE_HPP
+
+#include <gl/Buffer.hpp>
+#include <gl/Program.hpp>
+#include <gl/VAO.hpp>
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace tetra
+{
+    /**
+     * Whether and how a draw blends with the framebuffer.
+     */
+    struct BlendState
+    {
+        bool enabled;
+        GLenum source;
+        GLenum destination;
+
+        bool operator==(const BlendState& other) const;
+    };
+
+    /**
+     * A single draw, issued against whichever program and vao its key selects.
+     * Leave indexType as GL_NONE to draw arrays, otherwise first is the first
+     * index in the vao's element buffer and baseVertex is added to every index.
+     */
+    struct DrawCall
+    {
+        Primitive primitive;
+        GLint first;
+        GLsizei count;
+        GLenum indexType = GL_NONE;
+        GLint baseVertex = 0;
+        GLsizei instances = 1;
+    };
+
+    /**
+     * This class collects a frame's draws and issues them in an order which keeps
+     * program, vao and blend changes to a minimum.
+     * Each draw is submitted with a 64 bit sort key packing, from most to least
+     * significant: layer, program, vao, blend state and depth. flush() radix
+     * sorts the keys, so draws run layer by layer, and within a layer every draw
+     * sharing a program and vao runs back to back, grouped by blend state and
+     * then in increasing depth. Blend state is the cheapest of the three to
+     * switch, so it sits below program and vao. Depth only orders draws within
+     * a program, vao and blend state, so put translucent geometry which must be
+     * composited back to front across programs in a later layer.
+     *
+     * Programs, vaos and blend states get small ids the first time a key uses
+     * them, so keys for long-lived objects can be computed once and reused.
+     * Registered objects must outlive the queue. A Program reloaded in place
+     * (see ProgramLibrary) keeps its id.
+     *
+     * EXAMPLE:
+     *      auto queue = RenderQueue{};
+     *      auto additive = queue.blendState({true, GL_SRC_ALPHA, GL_ONE});
+     *      auto key = queue.key(1, program, vao, additive, 0.5f);
+     *      // each frame
+     *      queue.submit(key, DrawCall{Primitive::Triangles, 0, 6});
+     *      queue.flush();
+     */
+    class RenderQueue
+    {
+    public:
+        /**
+         * How many draws the last flush issued and how many times it had to
+         * switch program, vao and blend state to do so.
+         */
+        struct Stats
+        {
+            int draws = 0;
+            int programChanges = 0;
+            int vaoChanges = 0;
+            int blendChanges = 0;
+        };
+
+        /** Bits of each sort key field, most significant first */
+        static constexpr int LAYER_BITS = 8;
+        static constexpr int PROGRAM_BITS = 14;
+        static constexpr int VAO_BITS = 14;
+        static constexpr int BLEND_BITS = 4;
+        static constexpr int DEPTH_BITS = 24;
+
+        /**
+         * Create a queue. Blend state id 0 is always blending disabled.
+         */
+        RenderQueue();
+
+        /**
+         * Get the id of a blend state, registering it if this is its first use.
+         * @throws GLException if there are too many blend states for the key.
+         */
+        int blendState(const BlendState& state);
+
+        /**
+         * Pack a sort key.
+         * @param layer  drawn in increasing order, 0 to 255
+         * @param blend  an id from blendState()
+         * @param depth  sorted increasing within a program and vao, clamped to
+         *               [0, 1]. Use 1 - depth to draw blended geometry back to
+         *               front.
+         * @throws GLException if layer is out of range, blend is not a registered
+         *         blend state, or there are too many programs or vaos for the key.
+         */
+        std::uint64_t key(int layer, Program& program, const Vao& vao,
+                          int blend = 0, float depth = 0.0f);
+
+        /**
+         * Queue a draw for the next flush().
+         */
+        void submit(std::uint64_t key, const DrawCall& draw);
+
+        /**
+         * Queue a callback which issues its own draws once the key's program,
+         * vao and blend state are set, e.g. to set uniforms first.
+         * The callback must leave the program, vao and blend state as it found
+         * them.
+         */
+        void submit(std::uint64_t key, std::function<void()> draw);
+
+        /**
+         * Sort and issue every queued draw, then clear the queue.
+         * @param sort  false issues draws in submission order, for comparison.
+         */
+        Stats flush(bool sort = true);
+
+        /**
+         * The number of draws queued for the next flush().
+         */
+        int queued() const;
+
+    private:
+        struct Command
+        {
+            DrawCall draw;
+            std::function<void()> callback;
+        };
+
+        struct SortEntry
+        {
+            std::uint64_t key;
+            std::uint32_t command;
+        };
+
+        std::vector<Program*> programs;
+        std::vector<const Vao*> vaos;
+        std::vector<BlendState> blendStates;
+        std::unordered_map<const Program*, int> programIds;
+        std::unordered_map<const Vao*, int> vaoIds;
+
+        std::vector<Command> commands;
+        std::vector<SortEntry> entries;
+        std::vector<SortEntry> scratch;
+
+        Stats execute();
+    };
+} /* namespace tetra */
+
+#endif
@@ -12,6 +12,8 @@ namespace tetra
         VERTEX = GL_VERTEX_SHADER,
         FRAGMENT = GL_FRAGMENT_SHADER,
         GEOMETRY = GL_GEOMETRY_SHADER,
+        /** Min version 4.3, link it alone to make a compute program */
+        COMPUTE = GL_COMPUTE_SHADER,
     };
 
     /**
@@ -46,6 +48,25 @@ namespace tetra
          */
         void compile(const std::string& source);
 
+        /**
+         * Loads the source code for this shader and starts compiling it without
+         * waiting for the result. Call checkCompiled() once completed() is true, or
+         * leave the check to ProgramLinker.
+         */
+        void submit(const std::string& source);
+
+        /**
+         * True once the driver has finished compiling, so checkCompiled() won't
+         * block. Always true if the driver doesn't support parallel compiles.
+         */
+        bool completed();
+
+        /**
+         * Wait for the compile to finish and check the result.
+         * @throws GLException if there is an issue while compiling the shader.
+         */
+        void checkCompiled();
+
         /**
          * Return a non-owning reference to the OpenGL shader.
          */
@@ -0,0 +1,103 @@
+#ifndef STD140_HPP
+#define STD140_HPP
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+namespace tetra
+{
+    namespace std140
+    {
+        /**
+         * The std140 base alignment and size, in bytes, of a C++ type used as a
+         * uniform block member.
+         * Only types whose C++ representation matches std140 are defined, so a
+         * member like glm::mat3 (which std140 pads to three vec4 columns) or bool
+         * (4 bytes in GLSL) fails to compile instead of silently misreading.
+         */
+        template <class T>
+        struct layout;
+
+        template <std::size_t Alignment>
+        struct layoutOf
+        {
+            static constexpr std::size_t alignment = Alignment;
+        };
+
+        template <> struct layout<float> : layoutOf<4> {};
+        template <> struct layout<int> : layoutOf<4> {};
+        template <> struct layout<unsigned int> : layoutOf<4> {};
+
+        // by convention vectors are std::arrays of float, like vertex attributes
+        template <> struct layout<std::array<float, 1>> : layoutOf<4> {};
+        template <> struct layout<std::array<float, 2>> : layoutOf<8> {};
+        template <> struct layout<std::array<float, 3>> : layoutOf<16> {};
+        template <> struct layout<std::array<float, 4>> : layoutOf<16> {};
+
+        template <> struct layout<glm::vec2> : layoutOf<8> {};
+        template <> struct layout<glm::vec3> : layoutOf<16> {};
+        template <> struct layout<glm::vec4> : layoutOf<16> {};
+        template <> struct layout<glm::ivec2> : layoutOf<8> {};
+        template <> struct layout<glm::ivec3> : layoutOf<16> {};
+        template <> struct layout<glm::ivec4> : layoutOf<16> {};
+        template <> struct layout<glm::mat4> : layoutOf<16> {};
+
+        /**
+         * Arrays have a stride of a vec4, so their elements must already be a
+         * multiple of 16 bytes in C++ for the layouts to match.
+         */
+        template <class T, std::size_t N>
+        struct layout<T[N]> : layoutOf<16>
+        {
+            static_assert(sizeof(T) % 16 == 0,
+                          "std140 arrays have a 16 byte stride, use an element type "
+                          "which is a multiple of 16 bytes (e.g. glm::vec4)");
+        };
+
+        /**
+         * True if a member of type T placed at offset is aligned for std140.
+         */
+        template <class T>
+        constexpr bool alignedAt(std::size_t offset)
+        {
+            return offset % layout<T>::alignment == 0;
+        }
+
+        /**
+         * True if Block meets the whole-struct requirements for a uniform block.
+         * Declaring the struct alignas(16) takes care of the size requirement.
+         */
+        template <class Block>
+        constexpr bool validBlock()
+        {
+            return std::is_standard_layout<Block>::value
+                && std::is_trivially_copyable<Block>::value
+                && sizeof(Block) % 16 == 0;
+        }
+    } /* namespace std140 */
+} /* namespace tetra */
+
+/**
+ * Check at compile time that a uniform block member sits where std140 puts it.
+ * Place one after the struct definition for each member:
+ *
+ *      struct alignas(16) FrameUniforms
+ *      {
+ *          glm::mat4 projection;
+ *          float time;
+ *      };
+ *      STD140_MEMBER(FrameUniforms, projection);
+ *      STD140_MEMBER(FrameUniforms, time);
+ */
+#define STD140_MEMBER(Block, member)                                            \
+    static_assert(                                                              \
+        tetra::std140::alignedAt<decltype(Block::member)>(offsetof(Block, member)), \
+        #Block "::" #member " is not aligned according to std140")
+
+#endif
@@ -0,0 +1,214 @@
+#ifndef STREAMING_BUFFER_HPP
+#define STREAMING_BUFFER_HPP
+
+#include <gl/Buffer.hpp>
+#include <gl/GLException.hpp>
+#include <gl/GLState.hpp>
+
+#include <GL/glew.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace tetra
+{
+    /**
+     * This class streams per-frame data to the GL without reallocating storage.
+     * The underlying buffer gets immutable storage for 'regions' copies of up to
+     * 'capacity' elements which stays persistently mapped. Each write() goes into
+     * the next region, so the CPU fills one region while the GL reads the others.
+     * Fences guard each region so a write never stomps data the GL is still using.
+     *
+     * EXAMPLE:
+     *      auto stream = StreamingBuffer<Vertex>{
+     *          AttribBinder<Vertex>{vao}.attrib(&Vertex::pos).bind(), 1024
+     *      };
+     *      // each frame
+     *      stream.write(vertices);
+     *      stream.draw(Primitive::Points); // draws from stream.offset()
+     *
+     * Requires GL 4.4 or ARB_buffer_storage. Without DSA (GL 4.5) the storage is
+     * created and mapped through the copy write binding.
+     */
+    template <class Data>
+    class StreamingBuffer
+    {
+    public:
+        /**
+         * Take ownership of a buffer and give it persistently mapped storage.
+         * The buffer must not already have immutable storage.
+         * @throws GLException if the storage cannot be created or mapped.
+         */
+        StreamingBuffer(Buffer<Data>&& buffer, int capacity, int regions = 3)
+            : buffer{std::move(buffer)}
+            , _capacity{capacity}
+            , fences(regions, nullptr)
+            , region{0}
+            , _offset{0}
+            , _size{0}
+        {
+            const GLbitfield flags =
+                GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            const auto byteSize = sizeof(Data) * capacity * regions;
+
+            if (GLState::current().directStateAccess())
+            {
+                glNamedBufferStorage(this->buffer.raw(), byteSize, nullptr, flags);
+                mapped = static_cast<Data*>(
+                    glMapNamedBufferRange(this->buffer.raw(), 0, byteSize, flags)
+                );
+            }
+            else
+            {
+                // the copy target leaves the buffer's own target binding alone
+                GLState::current().bindBuffer(GL_COPY_WRITE_BUFFER, this->buffer.raw());
+                glBufferStorage(GL_COPY_WRITE_BUFFER, byteSize, nullptr, flags);
+                mapped = static_cast<Data*>(
+                    glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, byteSize, flags)
+                );
+            }
+            THROW_ON_GL_ERROR();
+        }
+
+        /**
+         * Streaming buffers cannot be copied.
+         */
+        StreamingBuffer(const StreamingBuffer&) = delete;
+
+        /**
+         * Transfer ownership of the buffer, mapping and fences.
+         */
+        StreamingBuffer(StreamingBuffer&& from)
+            : buffer{std::move(from.buffer)}
+            , _capacity{from._capacity}
+            , fences{std::move(from.fences)}
+            , mapped{from.mapped}
+            , region{from.region}
+            , _offset{from._offset}
+            , _size{from._size}
+        {
+            from.fences.clear();
+            from.mapped = nullptr;
+        }
+
+        /**
+         * Delete the outstanding fences. Deleting the buffer unmaps it.
+         */
+        ~StreamingBuffer()
+        {
+            for (auto fence : fences)
+            {
+                if (fence != nullptr)
+                {
+                    glDeleteSync(fence);
+                }
+            }
+        }
+
+        /**
+         * Copy data into the next region, waiting for the GL to finish with it first.
+         * @throws GLException if data holds more than capacity() elements.
+         */
+        void write(const std::vector<Data>& data)
+        {
+            if (data.size() > (std::size_t)_capacity)
+            {
+                throw GLException{ "StreamingBuffer write of"
+                                 , std::to_string(data.size())
+                                 , "elements exceeds the capacity of"
+                                 , std::to_string(_capacity)
+                                 };
+            }
+
+            region = (region + 1) % fences.size();
+            waitForRegion(region);
+
+            _offset = region * _capacity;
+            _size = data.size();
+            std::memcpy(mapped + _offset, data.data(), sizeof(Data) * _size);
+        }
+
+        /**
+         * Mark the current region as in use by the GL.
+         * Call this after issuing the draws which read from the current region.
+         */
+        void fence()
+        {
+            if (fences[region] != nullptr)
+            {
+                glDeleteSync(fences[region]);
+            }
+            fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+
+        /**
+         * Draw the current region using the provided primitive, then fence it.
+         */
+        void draw(Primitive primitive)
+        {
+            glDrawArrays(primitive, _offset, _size);
+            THROW_ON_GL_ERROR();
+            fence();
+        }
+
+        /**
+         * The index of the first element of the last write.
+         * Use this as the first vertex or base vertex when drawing.
+         */
+        int offset() const
+        {
+            return _offset;
+        }
+
+        /**
+         * The number of elements in the last write.
+         */
+        int size() const
+        {
+            return _size;
+        }
+
+        /**
+         * The maximum number of elements a single write can hold.
+         */
+        int capacity() const
+        {
+            return _capacity;
+        }
+
+        /**
+         * Get a non-owning reference to the raw OpenGL buffer object.
+         */
+        GLuint raw() const
+        {
+            return buffer.raw();
+        }
+
+    private:
+        Buffer<Data> buffer;
+        int _capacity;
+        std::vector<GLsync> fences;
+        Data* mapped;
+        int region;
+        int _offset;
+        int _size;
+
+        /**
+         * Block until the GL has finished reading from a region.
+         */
+        void waitForRegion(int index)
+        {
+            auto fence = fences[index];
+            if (fence == nullptr)
+            {
+                return;
+            }
+
+            fences[index] = nullptr;
+            hidden::waitAndDeleteFence(fence);
+        }
+    };
+} /* namespace tetra */
+
+#endif
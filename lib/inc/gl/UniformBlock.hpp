@@ -0,0 +1,102 @@
+#ifndef UNIFORM_BLOCK_HPP
+#define UNIFORM_BLOCK_HPP
+
+#include <gl/Buffer.hpp>
+#include <gl/GLException.hpp>
+#include <gl/GLState.hpp>
+#include <gl/Program.hpp>
+#include <gl/Std140.hpp>
+
+#include <GL/glew.h>
+
+#include <string>
+
+namespace tetra
+{
+    /**
+     * This class owns a Uniform Buffer Object holding a single Block, bound to an
+     * indexed uniform binding point.
+     * Every Program which attaches to the binding point reads the same data, so
+     * shared values (projection, time, ...) are uploaded once per frame no matter
+     * how many programs use them.
+     *
+     * Block must be std140 compatible: check it with STD140_MEMBER, see Std140.hpp.
+     *
+     * EXAMPLE:
+     *      // GLSL: layout(std140) uniform Frame { mat4 projection; };
+     *      auto frameUniforms = UniformBlock<FrameUniforms>{0};
+     *      frameUniforms.attach(program, "Frame");
+     *      // each frame
+     *      frameUniforms.write({ortho.value()});
+     */
+    template <class Block>
+    class UniformBlock
+    {
+        static_assert(std140::validBlock<Block>(),
+                      "Uniform blocks must be standard layout, trivially copyable, "
+                      "and a multiple of 16 bytes (try alignas(16))");
+
+    public:
+        /**
+         * Create the uniform buffer and bind it to the binding point.
+         */
+        UniformBlock(GLuint bindingPoint)
+            : buffer{BindTarget::Uniform}
+            , bindingPoint{bindingPoint}
+        {
+            buffer.reserve(1, UsageHint::DynamicDraw);
+            bind();
+        }
+
+        /**
+         * Upload the block's contents.
+         */
+        void write(const Block& block)
+        {
+            buffer.update(0, &block, 1);
+        }
+
+        /**
+         * Point the program's uniform block named blockName at this block's
+         * binding point.
+         * @throws GLException if the program has no active block with that name.
+         */
+        void attach(Program& program, const std::string& blockName)
+        {
+            auto index = glGetUniformBlockIndex(program.raw(), blockName.c_str());
+            if (index == GL_INVALID_INDEX)
+            {
+                throw GLException{ "No active uniform block named"
+                                 , blockName
+                                 , "in program"
+                                 , std::to_string(program.raw())
+                                 };
+            }
+            glUniformBlockBinding(program.raw(), index, bindingPoint);
+            THROW_ON_GL_ERROR();
+        }
+
+        /**
+         * Re-bind the buffer to the binding point, e.g. if something else used it.
+         */
+        void bind()
+        {
+            GLState::current().bindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, buffer.raw());
+            THROW_ON_GL_ERROR();
+        }
+
+        /**
+         * The indexed uniform binding point this block is bound to.
+         */
+        GLuint binding() const
+        {
+            return bindingPoint;
+        }
+
+    private:
+        Buffer<Block> buffer;
+        GLuint bindingPoint;
+    };
+} /* namespace tetra */
+
+#endif
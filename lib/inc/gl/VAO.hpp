@@ -2,6 +2,8 @@
 #define VAO_HPP
 
 #include <gl/Buffer.hpp>
+#include <gl/GLState.hpp>
+#include <gl/VertexLayout.hpp>
 
 #include <GL/glew.h>
 
@@ -44,58 +46,125 @@ namespace tetra
         GLuint raw() const;
 
         /**
-         * Bind the VAO.
+         * Bind the VAO, unless it is already bound.
          */
-        void bind() const;;
+        void bind() const;
+
+        /**
+         * Use the buffer as this VAO's element (index) buffer.
+         */
+        template <class Index>
+        void elementBuffer(const Buffer<Index>& indices)
+        {
+            if (GLState::current().directStateAccess())
+            {
+                glVertexArrayElementBuffer(handle, indices.raw());
+            }
+            else
+            {
+                bind();
+                GLState::current().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices.raw());
+            }
+            THROW_ON_GL_ERROR();
+        }
 
     private:
         bool shouldDelete;
         GLuint handle;
     };
 
-    struct IndexOffset
-    {
-        std::size_t offset;
-        int length;
-    };
-
+    /**
+     * This class describes how a VAO reads Vertex structs from a buffer.
+     * Attributes can be float, half, normalized integer, packed 10_10_10_2 or
+     * integer members, see VertexLayout.hpp.
+     *
+     * EXAMPLE:
+     *      auto buffer = AttribBinder<Vertex>{vao}
+     *          .attrib(&Vertex::pos)
+     *          .attrib(&Vertex::color)
+     *          .bind();
+     * OR, with the layout checked at compile time:
+     *      auto buffer = AttribBinder<Compact>{vao}.layout(compactLayout).bind();
+     *
+     * Per-instance attributes come from a second binder which starts after the
+     * vertex attributes and advances once per instance:
+     *      auto instances = AttribBinder<Sprite>{vao}
+     *          .firstIndex(1)
+     *          .divisor(1)
+     *          .attrib(&Sprite::offset)
+     *          .bind();
+     *      vertices.drawInstanced(Primitive::TriangleStrip, instances.size());
+     */
     template <class Vertex>
     class AttribBinder
     {
     public:
-        AttribBinder(Vao& vao) : vao{vao} {}
+        AttribBinder(Vao& vao) : vao{vao}, _firstIndex{0}, _divisor{0} {}
         AttribBinder(const AttribBinder&) = default;
 
-        template <std::array<float, 1>::size_type length>
-        AttribBinder& attrib(std::array<float, length> Vertex::*attrib)
+        /**
+         * The attribute index of the first attribute -- defaults to 0.
+         * Set this past the attributes of any other binder on the same vao.
+         */
+        AttribBinder& firstIndex(GLuint index)
         {
-            static Vertex* nullVtx = 0;
+            _firstIndex = index;
+            return *this;
+        }
 
-            auto offset = (std::size_t)&(nullVtx->*attrib);
-            attribs.push_back({ offset, length });
+        /**
+         * Advance these attributes once every divisor instances instead of once
+         * per vertex -- defaults to 0, per vertex.
+         */
+        AttribBinder& divisor(GLuint divisor)
+        {
+            _divisor = divisor;
             return *this;
         }
 
-        Buffer<Vertex> bind()
+        /**
+         * Add the next attribute from a member of the vertex.
+         * Fails to compile if the member's type can't be a vertex attribute.
+         */
+        template <class Member>
+        AttribBinder& attrib(Member Vertex::*member)
         {
-            vao.bind();
+            return attrib(vertexAttrib<Member>(offsetOf(member)));
+        }
 
-            auto buffer = Buffer<Vertex>{BindTarget::Array};
-            buffer.bind();
+        /**
+         * Add the next attribute from a description, see VERTEX_ATTRIB.
+         */
+        AttribBinder& attrib(const VertexAttrib& attrib)
+        {
+            attribs.push_back(attrib);
+            return *this;
+        }
 
-            for (int index = 0; index < attribs.size(); index++)
-            {
-                glEnableVertexAttribArray(index);
+        /**
+         * Add every attribute in a layout, in order.
+         */
+        template <std::size_t N>
+        AttribBinder& layout(const std::array<VertexAttrib, N>& layout)
+        {
+            attribs.insert(std::end(attribs), std::begin(layout), std::end(layout));
+            return *this;
+        }
 
-                auto attrib = attribs[index];
-                glVertexAttribPointer(
-                    index,
-                    attrib.length,
-                    GL_FLOAT,
-                    GL_FALSE,
-                    sizeof(Vertex),
-                    (const GLvoid*)attrib.offset
-                );
+        /**
+         * Create a vertex buffer and point the VAO's attributes at it.
+         * Attribute indices follow the order the attribs were added in.
+         */
+        Buffer<Vertex> bind()
+        {
+            auto buffer = Buffer<Vertex>{BindTarget::Array};
+            if (GLState::current().directStateAccess())
+            {
+                bindNamed(buffer);
+            }
+            else
+            {
+                bindCurrent(buffer);
             }
             THROW_ON_GL_ERROR();
 
@@ -104,7 +173,93 @@ namespace tetra
 
     private:
         Vao& vao;
-        std::vector<IndexOffset> attribs;
+        GLuint _firstIndex;
+        GLuint _divisor;
+        std::vector<VertexAttrib> attribs;
+
+        /**
+         * Measure a member's offset against a real vertex rather than a null
+         * pointer, which would be undefined behavior.
+         */
+        template <class Member>
+        static std::size_t offsetOf(Member Vertex::*member)
+        {
+            static const Vertex probe{};
+            return reinterpret_cast<const char*>(&(probe.*member))
+                 - reinterpret_cast<const char*>(&probe);
+        }
+
+        /**
+         * Describe the attributes with DSA calls, without binding anything.
+         * Every attribute reads from the binding point numbered after the first
+         * attribute index, so binders with different first indices don't clash.
+         */
+        void bindNamed(Buffer<Vertex>& buffer)
+        {
+            const GLuint binding = _firstIndex;
+            glVertexArrayVertexBuffer(vao.raw(), binding, buffer.raw(), 0, sizeof(Vertex));
+            glVertexArrayBindingDivisor(vao.raw(), binding, _divisor);
+
+            for (GLuint i = 0; i < attribs.size(); i++)
+            {
+                auto attrib = attribs[i];
+                auto index = _firstIndex + i;
+                glEnableVertexArrayAttrib(vao.raw(), index);
+                if (attrib.integer)
+                {
+                    glVertexArrayAttribIFormat(
+                        vao.raw(), index, attrib.size, attrib.type, attrib.offset
+                    );
+                }
+                else
+                {
+                    glVertexArrayAttribFormat(
+                        vao.raw(), index, attrib.size, attrib.type,
+                        attrib.normalized, attrib.offset
+                    );
+                }
+                glVertexArrayAttribBinding(vao.raw(), index, binding);
+            }
+        }
+
+        /**
+         * Describe the attributes by binding the VAO and buffer.
+         */
+        void bindCurrent(Buffer<Vertex>& buffer)
+        {
+            vao.bind();
+            buffer.bind();
+
+            for (GLuint i = 0; i < attribs.size(); i++)
+            {
+                auto attrib = attribs[i];
+                auto index = _firstIndex + i;
+                glEnableVertexAttribArray(index);
+                glVertexAttribDivisor(index, _divisor);
+
+                if (attrib.integer)
+                {
+                    glVertexAttribIPointer(
+                        index,
+                        attrib.size,
+                        attrib.type,
+                        sizeof(Vertex),
+                        (const GLvoid*)attrib.offset
+                    );
+                }
+                else
+                {
+                    glVertexAttribPointer(
+                        index,
+                        attrib.size,
+                        attrib.type,
+                        attrib.normalized,
+                        sizeof(Vertex),
+                        (const GLvoid*)attrib.offset
+                    );
+                }
+            }
+        }
     };
 } /* namespace tetra */
 
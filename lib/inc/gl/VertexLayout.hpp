@@ -0,0 +1,288 @@
+#ifndef VERTEX_LAYOUT_HPP
+#define VERTEX_LAYOUT_HPP
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace tetra
+{
+    /**
+     * Component types for compact vertex attributes.
+     * A vertex member's C++ type decides how the GL reads it:
+     *
+     *      std::array<float, N>            vecN
+     *      std::array<Half, N>             vecN from 16 bit floats
+     *      std::array<Norm<T>, N>          vecN from integers mapped to [0, 1]
+     *                                      (unsigned T) or [-1, 1] (signed T)
+     *      UNorm1010102 / SNorm1010102     vec4 from one packed 32 bit integer
+     *      std::array<T, N>, T integral    ivecN/uvecN, via glVertexAttribIPointer
+     *
+     * where T is one of the 8, 16 or 32 bit integer types.
+     */
+    namespace vertex
+    {
+        /** An IEEE 754 half precision float, see toHalf */
+        struct Half
+        {
+            std::uint16_t bits;
+        };
+
+        /** An integer the GL normalizes to a float */
+        template <class Int>
+        struct Norm
+        {
+            static_assert(std::is_integral<Int>::value && sizeof(Int) <= 2,
+                          "normalized attributes are 8 or 16 bit integers");
+            Int value;
+        };
+
+        /** x, y, z in 10 bits each and w in 2, all unsigned and normalized */
+        struct UNorm1010102
+        {
+            std::uint32_t bits;
+        };
+
+        /** x, y, z in 10 bits each and w in 2, all signed and normalized */
+        struct SNorm1010102
+        {
+            std::uint32_t bits;
+        };
+
+        /**
+         * Drop the low bits of value, rounding to nearest with ties to even.
+         */
+        inline std::uint32_t roundedShift(std::uint32_t value, int shift)
+        {
+            const std::uint32_t kept = value >> shift;
+            const std::uint32_t dropped = value & ((1u << shift) - 1);
+            const std::uint32_t halfway = 1u << (shift - 1);
+            const bool roundUp = dropped > halfway || (dropped == halfway && (kept & 1));
+            return kept + (roundUp ? 1 : 0);
+        }
+
+        /**
+         * Convert a float to the nearest half, overflowing to infinity.
+         */
+        inline Half toHalf(float value)
+        {
+            std::uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+
+            const std::uint32_t sign = (bits >> 16) & 0x8000;
+            const std::uint32_t floatExponent = (bits >> 23) & 0xff;
+            std::uint32_t mantissa = bits & 0x7fffff;
+            const int exponent = (int)floatExponent - 127 + 15;
+
+            if (floatExponent == 0xff)
+            {
+                // infinity stays infinity, NaN stays NaN
+                return Half{(std::uint16_t)(sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0))};
+            }
+            if (exponent >= 0x1f)
+            {
+                return Half{(std::uint16_t)(sign | 0x7c00)};
+            }
+            if (exponent <= 0)
+            {
+                // too small for a normal half, so make a subnormal or zero
+                if (exponent < -10)
+                {
+                    return Half{(std::uint16_t)sign};
+                }
+                mantissa |= 0x800000;
+                const auto half = roundedShift(mantissa, 14 - exponent);
+                return Half{(std::uint16_t)(sign | half)};
+            }
+
+            // rounding can carry into the exponent, which is still correct
+            const auto half = ((std::uint32_t)exponent << 10) + roundedShift(mantissa, 13);
+            return Half{(std::uint16_t)(sign | half)};
+        }
+
+        /**
+         * Convert a float in [0, 1] (unsigned Int) or [-1, 1] (signed Int) to a
+         * normalized integer, clamping values outside the range.
+         */
+        template <class Int>
+        Norm<Int> normalized(float value)
+        {
+            constexpr float max = (float)std::numeric_limits<Int>::max();
+            constexpr float min = std::is_signed<Int>::value ? -1.0f : 0.0f;
+            return Norm<Int>{(Int)std::lround(std::min(std::max(value, min), 1.0f) * max)};
+        }
+
+        /**
+         * Pack floats in [0, 1] into a UNorm1010102.
+         */
+        inline UNorm1010102 packUNorm1010102(float x, float y, float z, float w = 1.0f)
+        {
+            auto pack = [](float value, std::uint32_t max)
+            {
+                return (std::uint32_t)std::lround(std::min(std::max(value, 0.0f), 1.0f) * max);
+            };
+            return UNorm1010102{ pack(x, 1023)
+                               | pack(y, 1023) << 10
+                               | pack(z, 1023) << 20
+                               | pack(w, 3) << 30
+                               };
+        }
+
+        /**
+         * Pack floats in [-1, 1] into an SNorm1010102, e.g. for normals.
+         */
+        inline SNorm1010102 packSNorm1010102(float x, float y, float z, float w = 0.0f)
+        {
+            auto pack = [](float value, int max, std::uint32_t mask)
+            {
+                auto scaled = std::lround(std::min(std::max(value, -1.0f), 1.0f) * max);
+                return (std::uint32_t)scaled & mask;
+            };
+            return SNorm1010102{ pack(x, 511, 0x3ff)
+                               | pack(y, 511, 0x3ff) << 10
+                               | pack(z, 511, 0x3ff) << 20
+                               | pack(w, 1, 0x3) << 30
+                               };
+        }
+
+        /**
+         * How the GL reads one component type. Undefined for types which can't be
+         * vertex attributes.
+         */
+        template <class Component>
+        struct component;
+
+        template <GLenum Type, GLboolean Normalized, bool Integer>
+        struct componentOf
+        {
+            static constexpr GLenum type = Type;
+            static constexpr GLboolean normalized = Normalized;
+            static constexpr bool integer = Integer;
+        };
+
+        template <> struct component<float> : componentOf<GL_FLOAT, GL_FALSE, false> {};
+        template <> struct component<Half> : componentOf<GL_HALF_FLOAT, GL_FALSE, false> {};
+
+        template <> struct component<Norm<std::uint8_t>> : componentOf<GL_UNSIGNED_BYTE, GL_TRUE, false> {};
+        template <> struct component<Norm<std::int8_t>> : componentOf<GL_BYTE, GL_TRUE, false> {};
+        template <> struct component<Norm<std::uint16_t>> : componentOf<GL_UNSIGNED_SHORT, GL_TRUE, false> {};
+        template <> struct component<Norm<std::int16_t>> : componentOf<GL_SHORT, GL_TRUE, false> {};
+
+        template <> struct component<std::uint8_t> : componentOf<GL_UNSIGNED_BYTE, GL_FALSE, true> {};
+        template <> struct component<std::int8_t> : componentOf<GL_BYTE, GL_FALSE, true> {};
+        template <> struct component<std::uint16_t> : componentOf<GL_UNSIGNED_SHORT, GL_FALSE, true> {};
+        template <> struct component<std::int16_t> : componentOf<GL_SHORT, GL_FALSE, true> {};
+        template <> struct component<std::uint32_t> : componentOf<GL_UNSIGNED_INT, GL_FALSE, true> {};
+        template <> struct component<std::int32_t> : componentOf<GL_INT, GL_FALSE, true> {};
+
+        /**
+         * How the GL reads a whole vertex member.
+         */
+        template <class Member>
+        struct format;
+
+        template <class Component, std::size_t N>
+        struct format<std::array<Component, N>> : component<Component>
+        {
+            static_assert(N >= 1 && N <= 4, "vertex attributes have 1 to 4 components");
+            static_assert(sizeof(std::array<Component, N>) == N * sizeof(Component),
+                          "vertex attribute components must be tightly packed");
+            static constexpr GLint size = N;
+        };
+
+        template <>
+        struct format<UNorm1010102>
+            : componentOf<GL_UNSIGNED_INT_2_10_10_10_REV, GL_TRUE, false>
+        {
+            static constexpr GLint size = 4;
+        };
+
+        template <>
+        struct format<SNorm1010102>
+            : componentOf<GL_INT_2_10_10_10_REV, GL_TRUE, false>
+        {
+            static constexpr GLint size = 4;
+        };
+    } /* namespace vertex */
+
+    /**
+     * Where and how one attribute sits in a vertex.
+     */
+    struct VertexAttrib
+    {
+        std::size_t offset;
+        std::size_t bytes;
+        GLint size;
+        GLenum type;
+        GLboolean normalized;
+        bool integer; /** read as ivec/uvec with glVertexAttribIPointer */
+    };
+
+    /**
+     * Describe a member of type Member at offset in a vertex.
+     * Fails to compile if Member can't be a vertex attribute.
+     */
+    template <class Member>
+    constexpr VertexAttrib vertexAttrib(std::size_t offset)
+    {
+        using Format = vertex::format<Member>;
+        return VertexAttrib{ offset
+                           , sizeof(Member)
+                           , Format::size
+                           , Format::type
+                           , Format::normalized
+                           , Format::integer
+                           };
+    }
+
+    /**
+     * True if every attribute lies inside Vertex and no two overlap.
+     */
+    template <class Vertex, std::size_t N>
+    constexpr bool validLayout(const std::array<VertexAttrib, N>& attribs)
+    {
+        for (std::size_t i = 0; i < N; i++)
+        {
+            if (attribs[i].offset + attribs[i].bytes > sizeof(Vertex))
+            {
+                return false;
+            }
+            for (std::size_t j = i + 1; j < N; j++)
+            {
+                bool before = attribs[i].offset + attribs[i].bytes <= attribs[j].offset;
+                bool after = attribs[j].offset + attribs[j].bytes <= attribs[i].offset;
+                if (!before && !after)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+} /* namespace tetra */
+
+/**
+ * Describe a vertex member as a constexpr VertexAttrib, without the undefined
+ * behavior of measuring offsets through a null pointer.
+ *
+ *      struct Compact
+ *      {
+ *          std::array<vertex::Half, 2> pos;
+ *          std::array<vertex::Norm<std::uint8_t>, 4> color;
+ *      };
+ *      constexpr auto compactLayout = std::array<VertexAttrib, 2>{
+ *          VERTEX_ATTRIB(Compact, pos), VERTEX_ATTRIB(Compact, color)
+ *      };
+ *      static_assert(validLayout<Compact>(compactLayout), "overlapping attributes");
+ */
+#define VERTEX_ATTRIB(Vertex, member)                                            \
+    ::tetra::vertexAttrib<decltype(Vertex::member)>(offsetof(Vertex, member))
+
+#endif
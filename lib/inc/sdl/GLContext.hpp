@@ -1,8 +1,12 @@
 #ifndef GLCONTEXT_HPP
 #define GLCONTEXT_HPP
 
+#include <gl/GLState.hpp>
+
 #include <SDL.h>
 
+#include <memory>
+
 namespace tetra
 {
     class GLContext
@@ -30,6 +34,12 @@ namespace tetra
              */
             Builder& profileMask(int mask);
 
+            /**
+             * Use Direct State Access for buffers and vertex arrays when the context
+             * supports it (GL 4.5 or ARB_direct_state_access) -- defaults to true.
+             */
+            Builder& directStateAccess(bool enabled);
+
             /**
              * Construct a GLContext for a window.
              */
@@ -39,16 +49,23 @@ namespace tetra
             int _majorVersion;
             int _minorVersion;
             int _profileMask;
+            bool _directStateAccess;
             SDL_Window* _window;
         };
 
         GLContext(GLContext&&);
         GLContext(const GLContext&) = delete;
         ~GLContext();
+
+        /**
+         * The gl wrapper state for this context.
+         */
+        GLState& state();
     private:
         GLContext(SDL_GLContext);
 
         SDL_GLContext context;
+        std::unique_ptr<GLState> _state;
     };
 } /* namespac tetra */
 
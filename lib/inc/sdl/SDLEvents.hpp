@@ -17,6 +17,20 @@ namespace tetra
         int relx; /** Difference between last x and current x */
         int rely; /** Difference between last y and current y */
     };
+
+    /**
+     * Merge two mouse motion events into one which ends at the incoming position
+     * and carries the total relative motion of both.
+     */
+    inline SDLMousePosition accumulateMotion(const SDLMousePosition& pending,
+                                             const SDLMousePosition& incoming)
+    {
+        return { incoming.x
+               , incoming.y
+               , pending.relx + incoming.relx
+               , pending.rely + incoming.rely
+               };
+    }
 }; /* namespace tetra */
 
 #endif
@@ -78,6 +78,8 @@ namespace tetra
         public:
             /**
              * Create a new frame for the window.
+             * This resets the current GLState's counters, so they count the calls
+             * made during this frame.
              */
             Frame(SDLWindow&);
 
@@ -0,0 +1,75 @@
+#ifndef ASSET_WATCHER_HPP
+#define ASSET_WATCHER_HPP
+
+#include <tetra/EventStream.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+namespace tetra
+{
+    /**
+     * This event is fired when a file in a watched asset directory is written.
+     * name is relative to the directory, so for shaders it is the same name that
+     * loadShaderSrc takes.
+     */
+    struct AssetChanged
+    {
+        std::string directory; /** e.g. "shaders" */
+        std::string name; /** e.g. "lissajous.vert" */
+    };
+
+    inline bool operator==(const AssetChanged& a, const AssetChanged& b)
+    {
+        return a.directory == b.directory && a.name == b.name;
+    }
+
+    /**
+     * This class watches a directory under ASSET_ROOT with inotify and pushes an
+     * AssetChanged event each time a file in it is saved.
+     * The watching happens on a background thread, the events are delivered by
+     * the stream's dispatch() like any other event. Editors often write a file
+     * more than once per save, so duplicate pending events are dropped.
+     *
+     * EXAMPLE:
+     *      auto watcher = AssetWatcher{eventStream, "shaders"};
+     *      // AssetChanged{"shaders", "lissajous.vert"} arrives after a save
+     *
+     * Linux only.
+     */
+    class AssetWatcher
+    {
+    public:
+        /**
+         * Start watching ASSET_ROOT/directory.
+         * Must be created on the thread which owns the event stream.
+         * @throws FailedToLoadAsset if the directory cannot be watched.
+         */
+        AssetWatcher(EventStream& eventStream, const std::string& directory);
+
+        /**
+         * The background thread refers to this object, so it cannot be copied.
+         */
+        AssetWatcher(const AssetWatcher&) = delete;
+
+        /**
+         * Stop the background thread and the watch.
+         */
+        ~AssetWatcher();
+
+    private:
+        EventStream& eventStream;
+        const std::string directory;
+        int inotify;
+        std::atomic<bool> running;
+        std::thread watcher;
+
+        /**
+         * Push events for changed files until running is cleared.
+         */
+        void watch();
+    };
+} /* namespace tetra */
+
+#endif
@@ -0,0 +1,124 @@
+#pragma once
+#ifndef EVENT_HPP
+#define EVENT_HPP
+
+#include <memory>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+namespace tetra
+{
+
+/**
+ * A cheap, unique identifier for a type.
+ * Each type gets the address of its own static variable, so comparing and
+ * hashing ids is just comparing and hashing pointers.
+ * The variable is deliberately not const: identical constants may be merged
+ * (-fmerge-all-constants, linker ICF), which would give two types one id.
+ */
+using EventTypeId = const void*;
+
+template <class T>
+EventTypeId eventTypeId()
+{
+    static char id;
+    return &id;
+}
+
+/**
+ * This class holds a single event of any type.
+ * Small trivially-copyable events (like everything in SDLEvents.hpp) are stored
+ * inline, so creating, copying and destroying them never touches the heap.
+ * Larger or non-trivial events fall back to a shared heap allocation.
+ *
+ * EXAMPLE:
+ *      auto event = Event{SDLWindowSize{800, 600}};
+ *      if (event.is<SDLWindowSize>())
+ *      {
+ *          int width = event.get<SDLWindowSize>().width;
+ *      }
+ */
+class Event
+{
+public:
+    static constexpr std::size_t InlineSize = 32;
+
+    /**
+     * True if events of type T are stored without a heap allocation.
+     */
+    template <class T>
+    static constexpr bool storedInline()
+    {
+        return std::is_trivially_copyable<T>::value
+            && sizeof(T) <= InlineSize
+            && alignof(T) <= alignof(std::max_align_t);
+    }
+
+    /**
+     * Create an empty event which has no type.
+     */
+    Event() : typeId{nullptr}, storage{} {}
+
+    /**
+     * Create an event holding a copy of value.
+     */
+    template <class T,
+              class = std::enable_if_t<!std::is_same<std::decay_t<T>, Event>::value>>
+    Event(T&& value)
+        : typeId{eventTypeId<std::decay_t<T>>()}
+    {
+        using Stored = std::decay_t<T>;
+        if constexpr (storedInline<Stored>())
+        {
+            std::memcpy(&storage, &value, sizeof(Stored));
+        }
+        else
+        {
+            boxed = std::make_shared<Stored>(std::forward<T>(value));
+        }
+    }
+
+    /**
+     * The identifier of the held event's type, or nullptr if empty.
+     */
+    EventTypeId type() const
+    {
+        return typeId;
+    }
+
+    /**
+     * True if the held event is a T.
+     */
+    template <class T>
+    bool is() const
+    {
+        return typeId == eventTypeId<T>();
+    }
+
+    /**
+     * Access the held event as a T.
+     * The result is undefined unless is<T>() is true.
+     */
+    template <class T>
+    const T& get() const
+    {
+        if constexpr (storedInline<T>())
+        {
+            return *reinterpret_cast<const T*>(&storage);
+        }
+        else
+        {
+            return *static_cast<const T*>(boxed.get());
+        }
+    }
+
+private:
+    EventTypeId typeId;
+    std::aligned_storage_t<InlineSize, alignof(std::max_align_t)> storage;
+    std::shared_ptr<void> boxed;
+};
+
+} /* namespace tetra */
+
+#endif
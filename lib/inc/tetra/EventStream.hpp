@@ -1,15 +1,24 @@
 #ifndef EVENTSTREAM_HPP
 #define EVENTSTREAM_HPP
 
+#include <tetra/Event.hpp>
+#include <tetra/MpscQueue.hpp>
+#include <tetra/RingBuffer.hpp>
+
 #include <vector>
+#include <cstdint>
 #include <functional>
-#include <boost/any.hpp>
+#include <unordered_map>
+#include <thread>
 
 namespace tetra
 {
     /**
      * This class represents a continuous stream of events.
      * Other classes are allowed to subscribe to events and publish new events.
+     *
+     * The stream is owned by the thread which created it. Any thread may push()
+     * events, but listeners, coalescing and dispatch() belong to the owning thread.
      */
     class EventStream
     {
@@ -17,7 +26,7 @@ namespace tetra
         // Fwd declare, defined below
         class AutoRemoveListener;
         using ObserverId = int;
-        using Listener = std::function<void(const boost::any&)>;
+        using Listener = std::function<void(const Event&)>;
 
         /**
          * Create a new event stream.
@@ -27,11 +36,61 @@ namespace tetra
         /**
          * Push a new event into the stream.
          * This will be handled by the next call to update().
+         * Small trivially-copyable events are queued without any heap allocation,
+         * see Event for details.
+         * Safe to call from any thread. Events from other threads go through a
+         * lock-free queue and join the stream at the start of the next dispatch().
+         */
+        void push(Event event);
+
+        /**
+         * Coalesce events of EventType which are pushed while an earlier one is
+         * still waiting to be dispatched.
+         * Instead of queueing the new event, the pending one is replaced in place by
+         *   EventType merge(const EventType& pending, const EventType& incoming)
+         * so listeners see a single merged event at the pending event's position.
+         */
+        template <class EventType, class Merge>
+        void coalesce(Merge merge)
+        {
+            coalescers[eventTypeId<EventType>()] = Coalescer{0,
+                [=](Event& pending, const Event& incoming)
+                {
+                    pending = Event{merge(pending.get<EventType>(),
+                                          incoming.get<EventType>())};
+                    return true;
+                }};
+        }
+
+        /**
+         * Coalesce events of EventType so only the latest pending one is dispatched.
          */
-        void push(boost::any event);
+        template <class EventType>
+        void keepLatest()
+        {
+            coalesce<EventType>([](const EventType&, const EventType& incoming)
+            {
+                return incoming;
+            });
+        }
+
+        /**
+         * Drop events of EventType which compare equal to the pending one.
+         * Requires an operator== for EventType.
+         */
+        template <class EventType>
+        void dropDuplicates()
+        {
+            coalescers[eventTypeId<EventType>()] = Coalescer{0,
+                [](Event& pending, const Event& incoming)
+                {
+                    return pending.get<EventType>() == incoming.get<EventType>();
+                }};
+        }
 
         /**
          * Dispatch all of the events currently in the stream to listeners.
+         * Each event is only handed to the listeners registered for its type.
          */
         void dispatch();
 
@@ -53,14 +112,13 @@ namespace tetra
                                        void (TListener::*method)(const EventType&))
         {
             TListener* instancePtr = &instance;
-            listeners.emplace_back(nextId(), [=](const boost::any& event)
+            auto& bucket = listeners[eventTypeId<EventType>()];
+            bucket.emplace_back(nextId(), [=](const Event& event)
             {
-                if (event.type() == boost::typeindex::type_id<EventType>())
-                {
-                    (instancePtr->*method)(boost::any_cast<const EventType&>(event));
-                }
+                // the bucket guarantees the type, so no need to check it
+                (instancePtr->*method)(event.get<EventType>());
             });
-            return AutoRemoveListener(*this, listeners.back().first);;
+            return AutoRemoveListener(*this, bucket.back().first);
         }
 
         /**
@@ -81,13 +139,32 @@ namespace tetra
         };
 
     private:
-        std::vector<boost::any> events;
-        std::vector<std::pair<ObserverId, Listener>> listeners;
+        using ListenerBucket = std::vector<std::pair<ObserverId, Listener>>;
+
+        /**
+         * Coalescing state for a single event type.
+         * merge returns true if the incoming event was folded into the pending one.
+         */
+        struct Coalescer
+        {
+            /** One past the sequence number of the last queued event, 0 if none */
+            std::uint64_t lastQueued;
+            std::function<bool(Event& pending, const Event& incoming)> merge;
+        };
+
+        RingBuffer<Event> events;
+        MpscQueue<Event> incoming;
+        const std::thread::id owner;
+        std::unordered_map<EventTypeId, ListenerBucket> listeners;
+        std::unordered_map<EventTypeId, Coalescer> coalescers;
+        std::uint64_t pushedCount = 0;
+        std::uint64_t dispatchedCount = 0;
         ObserverId lastId = 0;
         const int maxEventsPerUpdate;
 
         ObserverId nextId();
         void remove(ObserverId id);
+        void enqueue(Event event);
     };
 } /* namespace tetra */
 
@@ -0,0 +1,64 @@
+#ifndef FNV1A_HPP
+#define FNV1A_HPP
+
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace tetra
+{
+    /**
+     * 64 bit FNV-1a, stable across runs and platforms unlike std::hash.
+     * Used to key on-disk caches, so the output must never change.
+     *
+     * EXAMPLE:
+     *      auto key = Fnv1a{}.add(vendor).add(source).hex();
+     */
+    class Fnv1a
+    {
+    public:
+        /**
+         * Hash a field. Each field is prefixed with its length, so ("ab", "c")
+         * and ("a", "bc") differ whatever bytes the fields hold.
+         */
+        Fnv1a& add(std::string_view bytes)
+        {
+            // little endian whatever the platform, so hashes stay portable
+            const std::uint64_t length = bytes.size();
+            for (int shift = 0; shift < 64; shift += 8)
+            {
+                mix((length >> shift) & 0xff);
+            }
+            for (unsigned char byte : bytes)
+            {
+                mix(byte);
+            }
+            return *this;
+        }
+
+        std::uint64_t value() const
+        {
+            return hash;
+        }
+
+        std::string hex() const
+        {
+            std::stringstream ss;
+            ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+            return ss.str();
+        }
+
+    private:
+        static constexpr std::uint64_t PRIME = 1099511628211ull;
+        std::uint64_t hash = 14695981039346656037ull;
+
+        void mix(std::uint64_t byte)
+        {
+            hash = (hash ^ byte) * PRIME;
+        }
+    };
+} /* namespace tetra */
+
+#endif
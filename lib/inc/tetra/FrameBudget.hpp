@@ -0,0 +1,54 @@
+#ifndef FRAME_BUDGET_HPP
+#define FRAME_BUDGET_HPP
+
+#include <deque>
+#include <functional>
+
+namespace tetra
+{
+    /**
+     * This class spreads work which must happen on the render thread, like
+     * compiling shaders or uploading buffers, across frames.
+     * Each frame run() works through the queued jobs until the frame's time budget
+     * is spent, so a burst of loads finishes over a few frames instead of
+     * stalling one.
+     *
+     * A job returns true when it is done, or false to be run again next frame,
+     * e.g. while it waits for a PendingProgram to be ready.
+     *
+     * EXAMPLE:
+     *      auto budget = FrameBudget{};
+     *      budget.post([&]() { texture.upload(pixels); return true; });
+     *      // each frame
+     *      budget.run(0.002); // at most ~2ms of loading work
+     */
+    class FrameBudget
+    {
+    public:
+        using Job = std::function<bool()>;
+
+        /**
+         * Queue a job for the next run().
+         * Must be called on the render thread.
+         */
+        void post(Job job);
+
+        /**
+         * Run jobs in order until they are all done or seconds have passed.
+         * At least one job runs each call, so a job longer than the budget still
+         * makes progress. Jobs which aren't done go to the back of the queue.
+         * @return the number of jobs which finished.
+         */
+        int run(double seconds);
+
+        /**
+         * The number of jobs waiting to run or to finish.
+         */
+        int pending() const;
+
+    private:
+        std::deque<Job> jobs;
+    };
+} /* namespace tetra */
+
+#endif
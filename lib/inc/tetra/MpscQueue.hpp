@@ -0,0 +1,102 @@
+#pragma once
+#ifndef MPSC_QUEUE_HPP
+#define MPSC_QUEUE_HPP
+
+#include <atomic>
+#include <utility>
+
+namespace tetra
+{
+
+/**
+ * This class is an unbounded lock-free multi-producer single-consumer FIFO queue.
+ * Any number of threads may push() concurrently, but only one thread at a time
+ * may pop().
+ * Pushing is a single atomic exchange (plus a node allocation), so producers
+ * never block each other or the consumer.
+ *
+ * EXAMPLE:
+ *      auto queue = MpscQueue<int>{};
+ *      // on any thread
+ *      queue.push(1);
+ *      // on the consumer thread
+ *      int value;
+ *      while (queue.pop(value)) { ... }
+ */
+template <class T>
+class MpscQueue
+{
+public:
+    /**
+     * Create an empty queue.
+     */
+    MpscQueue()
+        : head{new Node{}}
+        , tail{head.load()}
+    { }
+
+    /**
+     * The queue cannot be copied or moved while producers may hold references.
+     */
+    MpscQueue(const MpscQueue&) = delete;
+
+    /**
+     * Destroy the queue and any elements which were never popped.
+     */
+    ~MpscQueue()
+    {
+        while (tail != nullptr)
+        {
+            Node* next = tail->next.load(std::memory_order_relaxed);
+            delete tail;
+            tail = next;
+        }
+    }
+
+    /**
+     * Add an element to the back of the queue.
+     * Safe to call from any thread.
+     */
+    void push(T value)
+    {
+        Node* node = new Node{};
+        node->value = std::move(value);
+
+        Node* previous = head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    /**
+     * Move the element at the front of the queue into value.
+     * Only call this from the consumer thread.
+     * @return false if the queue was empty (or a push is still in flight)
+     */
+    bool pop(T& value)
+    {
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (next == nullptr)
+        {
+            return false;
+        }
+
+        value = std::move(next->value);
+        next->value = T{};
+        delete tail;
+        tail = next;
+        return true;
+    }
+
+private:
+    struct Node
+    {
+        std::atomic<Node*> next{nullptr};
+        T value;
+    };
+
+    std::atomic<Node*> head;
+    Node* tail;
+};
+
+} /* namespace tetra */
+
+#endif
@@ -0,0 +1,144 @@
+#ifndef PROXIMITY_GRID_HPP
+#define PROXIMITY_GRID_HPP
+
+#include <array>
+#include <vector>
+
+namespace tetra
+{
+    /**
+     * This class finds every pair of 2D points closer than a cutoff distance.
+     * Points are binned into a uniform grid of cells at least cutoff wide, so
+     * each point is only compared against points in its own and neighbouring
+     * cells. For N points with k neighbours each this costs O(N + N*k) instead
+     * of comparing all N*(N-1)/2 pairs.
+     * Storage is reused between builds, so once warmed up rebuilding every frame
+     * doesn't allocate.
+     *
+     * EXAMPLE:
+     *      auto grid = ProximityGrid{};
+     *      grid.build(vertices, &Vertex::pos, 0.1f);
+     *      grid.pairs(indices); // i, j, i, j, ... ready for Primitive::Lines
+     */
+    class ProximityGrid
+    {
+    public:
+        using Position = std::array<float, 2>;
+
+        /**
+         * Bin the positions of points, read through the member pointer.
+         */
+        template <class Point>
+        void build(const std::vector<Point>& points,
+                   Position Point::*position,
+                   float cutoff)
+        {
+            positions.clear();
+            for (const auto& point : points)
+            {
+                positions.push_back(point.*position);
+            }
+            bin(cutoff);
+        }
+
+        /**
+         * Bin a list of positions.
+         */
+        void build(const std::vector<Position>& points, float cutoff);
+
+        /**
+         * Replace indices with the index pairs of every two points closer than
+         * the cutoff. Each pair appears once.
+         * Index must be able to hold the largest point index, see size().
+         */
+        template <class Index>
+        void pairs(std::vector<Index>& indices) const
+        {
+            indices.clear();
+            forEachPair([&](int i, int j) {
+                indices.push_back(i);
+                indices.push_back(j);
+            });
+        }
+
+        /**
+         * Call visit(i, j) for each pair of points closer than the cutoff.
+         */
+        template <class Visit>
+        void forEachPair(Visit&& visit) const
+        {
+            // half of the neighbourhood, so each pair of cells is visited once
+            constexpr int NEIGHBOURS = 4;
+            constexpr int dx[NEIGHBOURS] = {1, -1, 0, 1};
+            constexpr int dy[NEIGHBOURS] = {0, 1, 1, 1};
+
+            for (int row = 0; row < rows; row++)
+            {
+                for (int column = 0; column < columns; column++)
+                {
+                    const int cell = row*columns + column;
+                    for (int a = cellStart[cell]; a < cellStart[cell + 1]; a++)
+                    {
+                        for (int b = a + 1; b < cellStart[cell + 1]; b++)
+                        {
+                            visitIfClose(sorted[a], sorted[b], visit);
+                        }
+                    }
+
+                    for (int n = 0; n < NEIGHBOURS; n++)
+                    {
+                        const int x = column + dx[n];
+                        const int y = row + dy[n];
+                        if (x < 0 || x >= columns || y >= rows)
+                        {
+                            continue;
+                        }
+
+                        const int other = y*columns + x;
+                        for (int a = cellStart[cell]; a < cellStart[cell + 1]; a++)
+                        {
+                            for (int b = cellStart[other]; b < cellStart[other + 1]; b++)
+                            {
+                                visitIfClose(sorted[a], sorted[b], visit);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        /**
+         * The number of points in the last build.
+         */
+        int size() const;
+
+    private:
+        std::vector<Position> positions;
+        /** Point indices ordered by cell */
+        std::vector<int> sorted;
+        /** The first entry of each cell in sorted, plus one past the end */
+        std::vector<int> cellStart;
+        std::vector<int> cellOf;
+        float cutoffSquared = 0.0f;
+        int columns = 0;
+        int rows = 0;
+
+        /**
+         * Counting sort the positions into cells.
+         */
+        void bin(float cutoff);
+
+        template <class Visit>
+        void visitIfClose(int i, int j, Visit& visit) const
+        {
+            const float x = positions[i][0] - positions[j][0];
+            const float y = positions[i][1] - positions[j][1];
+            if (x*x + y*y < cutoffSquared)
+            {
+                visit(i, j);
+            }
+        }
+    };
+} /* namespace tetra */
+
+#endif
@@ -0,0 +1,143 @@
+#pragma once
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+#include <vector>
+#include <utility>
+
+namespace tetra
+{
+
+/**
+ * This class is a growable FIFO queue backed by a circular array.
+ * Pushing to the back and popping from the front are both O(1) (amortized for
+ * push), and the storage is reused once the queue has grown to its working size.
+ *
+ * EXAMPLE:
+ *      auto queue = RingBuffer<int>{};
+ *      queue.push(1);
+ *      queue.push(2);
+ *      int first = queue.pop(); // first == 1
+ */
+template <class T>
+class RingBuffer
+{
+public:
+    /**
+     * Create a ring buffer with room for at least initialCapacity elements.
+     */
+    RingBuffer(std::size_t initialCapacity = 16)
+        : storage(roundUpToPowerOfTwo(initialCapacity))
+        , head{0}
+        , count{0}
+    { }
+
+    /**
+     * Add an element to the back of the queue, growing the storage if full.
+     */
+    void push(T value)
+    {
+        if (count == storage.size())
+        {
+            grow();
+        }
+        storage[(head + count) & mask()] = std::move(value);
+        count += 1;
+    }
+
+    /**
+     * Remove and return the element at the front of the queue.
+     * The queue must not be empty.
+     */
+    T pop()
+    {
+        T value = std::move(storage[head]);
+        storage[head] = T{};
+        head = (head + 1) & mask();
+        count -= 1;
+        return value;
+    }
+
+    /**
+     * Access the element at the front of the queue.
+     * The queue must not be empty.
+     */
+    T& front()
+    {
+        return storage[head];
+    }
+
+    /**
+     * Access the element which is index positions behind the front of the queue.
+     * The index must be less than size().
+     */
+    T& operator[](std::size_t index)
+    {
+        return storage[(head + index) & mask()];
+    }
+
+    /**
+     * True when there are no elements in the queue.
+     */
+    bool empty() const
+    {
+        return count == 0;
+    }
+
+    /**
+     * The number of elements currently in the queue.
+     */
+    std::size_t size() const
+    {
+        return count;
+    }
+
+    /**
+     * The number of elements the queue can hold before it needs to grow.
+     */
+    std::size_t capacity() const
+    {
+        return storage.size();
+    }
+
+private:
+    std::vector<T> storage;
+    std::size_t head;
+    std::size_t count;
+
+    /**
+     * Capacity is always a power of two so wrapping is a single mask.
+     */
+    std::size_t mask() const
+    {
+        return storage.size() - 1;
+    }
+
+    /**
+     * Double the capacity, unwrapping the elements to the start of the storage.
+     */
+    void grow()
+    {
+        auto grown = std::vector<T>(storage.size() * 2);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            grown[i] = std::move(storage[(head + i) & mask()]);
+        }
+        storage.swap(grown);
+        head = 0;
+    }
+
+    static std::size_t roundUpToPowerOfTwo(std::size_t n)
+    {
+        std::size_t capacity = 1;
+        while (capacity < n)
+        {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+};
+
+} /* namespace tetra */
+
+#endif
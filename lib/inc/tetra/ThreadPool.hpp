@@ -0,0 +1,68 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tetra
+{
+    /**
+     * This class runs tasks on a fixed set of worker threads.
+     * Tasks run in the order they were submitted, but several can run at once.
+     *
+     * EXAMPLE:
+     *      auto pool = ThreadPool{2};
+     *      pool.submit([&]() { eventStream.push(expensiveWork()); });
+     */
+    class ThreadPool
+    {
+    public:
+        using Task = std::function<void()>;
+
+        /**
+         * Start the worker threads.
+         */
+        ThreadPool(int threads);
+
+        /**
+         * Workers refer to the pool, so it cannot be copied.
+         */
+        ThreadPool(const ThreadPool&) = delete;
+
+        /**
+         * Stop the pool, see stop().
+         */
+        ~ThreadPool();
+
+        /**
+         * Drop the tasks which haven't started and wait for running tasks.
+         * Tasks submitted afterwards never run. Calling it again does nothing.
+         * @return the number of tasks dropped, e.g. to settle their bookkeeping
+         */
+        int stop();
+
+        /**
+         * Queue a task to run on the next free worker.
+         * Safe to call from any thread.
+         */
+        void submit(Task task);
+
+    private:
+        std::mutex lock;
+        std::condition_variable wake;
+        std::deque<Task> tasks;
+        bool stopping;
+        std::vector<std::thread> workers;
+
+        /**
+         * Run tasks until the pool stops.
+         */
+        void work();
+    };
+} /* namespace tetra */
+
+#endif
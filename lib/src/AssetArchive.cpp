@@ -0,0 +1,121 @@
+#include <AssetArchive.hpp>
+#include <Assets.hpp>
+
+#ifdef TETRA_LZ4
+#include <lz4.h>
+#endif
+
+#include <cstring>
+
+using namespace std;
+using namespace tetra;
+using namespace tetra::archive;
+
+AssetArchive::AssetArchive(const string& path)
+    : path{path}
+    , file{path, path}
+{
+    const auto data = file.data();
+    auto fail = [&](const string& reason)
+    {
+        return FailedToLoadAsset{"asset archive", path, reason};
+    };
+
+    if (data.size() < sizeof(Header))
+    {
+        throw fail("it is too short to be an archive");
+    }
+    const auto header = reinterpret_cast<const Header*>(data.data());
+    if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION)
+    {
+        throw fail("it is not a version " + to_string(VERSION) + " asset archive");
+    }
+
+    const auto indexEnd = sizeof(Header) + header->entryCount * sizeof(IndexEntry);
+    if (data.size() < indexEnd + header->namesSize)
+    {
+        throw fail("the index is truncated");
+    }
+    const auto index = reinterpret_cast<const IndexEntry*>(data.data() + sizeof(Header));
+    const auto names = data.substr(indexEnd, header->namesSize);
+
+    entries.reserve(header->entryCount);
+    for (uint32_t i = 0; i < header->entryCount; i++)
+    {
+        const auto& entry = index[i];
+        // compare against what's left rather than adding, which could wrap
+        if (entry.offset > data.size() ||
+            entry.storedSize > data.size() - entry.offset ||
+            entry.nameOffset > names.size() ||
+            entry.nameLength > names.size() - entry.nameOffset)
+        {
+            throw fail("entry " + to_string(i) + " is out of bounds");
+        }
+
+        auto stored = Entry{&entry, AssetView{}, string{}};
+        if ((entry.flags & LZ4) == 0)
+        {
+            if (entry.size != entry.storedSize)
+            {
+                throw fail("entry " + to_string(i) +
+                           " is uncompressed but its size and stored size differ");
+            }
+            stored.view = AssetView{data.substr(entry.offset, entry.storedSize), entry.hash};
+        }
+#ifndef TETRA_LZ4
+        else
+        {
+            throw fail("it has compressed entries and LZ4 support was not built");
+        }
+#endif
+        auto name = names.substr(entry.nameOffset, entry.nameLength);
+        entries.emplace(string(name), move(stored));
+    }
+}
+
+const AssetView*
+AssetArchive::find(const string& name)
+{
+    auto found = entries.find(name);
+    if (found == end(entries))
+    {
+        return nullptr;
+    }
+
+    auto& entry = found->second;
+    if ((entry.index->flags & LZ4) != 0 && entry.view.data.data() == nullptr)
+    {
+        decompress(name, entry);
+    }
+    return &entry.view;
+}
+
+int
+AssetArchive::size() const
+{
+    return entries.size();
+}
+
+void
+AssetArchive::decompress(const string& name, Entry& entry)
+{
+#ifdef TETRA_LZ4
+    const auto& index = *entry.index;
+    entry.decompressed.resize(index.size);
+    const auto written = LZ4_decompress_safe(
+        file.data().data() + index.offset,
+        &entry.decompressed[0],
+        index.storedSize,
+        index.size
+    );
+    if (written < 0 || (uint64_t)written != index.size)
+    {
+        throw FailedToLoadAsset{name, path, "the compressed entry is corrupt"};
+    }
+    entry.view = AssetView{entry.decompressed, index.hash};
+#else
+    (void)entry;
+    // the constructor refuses compressed archives without LZ4
+    throw FailedToLoadAsset{name, path, "LZ4 support was not built"};
+#endif
+}
@@ -0,0 +1,238 @@
+#include <AssetCache.hpp>
+#include <AssetArchive.hpp>
+#include <Assets.hpp>
+#include <AssetRoot.h>
+#include <MappedFile.hpp>
+#include <tetra/Fnv1a.hpp>
+
+#include <unistd.h>
+
+#include <algorithm>
+
+using namespace std;
+using namespace tetra;
+
+namespace
+{
+    const string SHADER_DIRECTORY = "shaders/";
+
+    /**
+     * If line is an #include directive, get the included file's name.
+     */
+    bool includedName(string_view line, string_view& name)
+    {
+        const auto directive = string_view{"#include"};
+        auto start = line.find_first_not_of(" \t");
+        if (start == string_view::npos || line.compare(start, directive.size(), directive) != 0)
+        {
+            return false;
+        }
+
+        auto open = line.find('"', start + directive.size());
+        auto close = open == string_view::npos ? open : line.find('"', open + 1);
+        if (close == string_view::npos)
+        {
+            return false;
+        }
+        name = line.substr(open + 1, close - open - 1);
+        return true;
+    }
+}
+
+namespace
+{
+    /**
+     * The configured archive path if the archive has been built.
+     */
+    string builtArchive()
+    {
+#ifdef ASSET_ARCHIVE
+        const auto path = string{ASSET_ARCHIVE};
+        return access(path.c_str(), R_OK) == 0 ? path : string{};
+#else
+        return string{};
+#endif
+    }
+}
+
+AssetCache::AssetCache()
+    : AssetCache{ASSET_ROOT, builtArchive()}
+{ }
+
+AssetCache::AssetCache(const string& root, const string& archive)
+    : root{root}
+    , archive{archive.empty() ? nullptr : new AssetArchive{archive}}
+{ }
+
+AssetCache::~AssetCache() = default;
+
+AssetView
+AssetCache::load(const string& path)
+{
+    auto guard = lock_guard<recursive_mutex>{lock};
+    auto found = files.find(path);
+    if (found != end(files))
+    {
+        return found->second.view;
+    }
+
+    auto loaded = LoadedFile{};
+    auto packed = (archive && loose.count(path) == 0) ? archive->find(path) : nullptr;
+    if (packed != nullptr)
+    {
+        loaded.view = *packed;
+    }
+    else
+    {
+        loaded.file.reset(new MappedFile{path, root + "/" + path});
+        auto data = loaded.file->data();
+        loaded.view = AssetView{data, Fnv1a{}.add(data).value()};
+    }
+    auto& stored = files[path] = move(loaded);
+    return stored.view;
+}
+
+AssetView
+AssetCache::shader(const string& name)
+{
+    auto guard = lock_guard<recursive_mutex>{lock};
+    auto stack = vector<string>{};
+    return expand(name, stack).view;
+}
+
+AssetCopy
+AssetCache::copy(const string& path)
+{
+    auto guard = lock_guard<recursive_mutex>{lock};
+    const auto view = load(path);
+    return AssetCopy{string{view.data}, view.hash};
+}
+
+AssetCopy
+AssetCache::copyShader(const string& name)
+{
+    auto guard = lock_guard<recursive_mutex>{lock};
+    const auto view = shader(name);
+    return AssetCopy{string{view.data}, view.hash};
+}
+
+vector<string>
+AssetCache::includes(const string& name)
+{
+    auto guard = lock_guard<recursive_mutex>{lock};
+    auto stack = vector<string>{};
+    return expand(name, stack).includes;
+}
+
+void
+AssetCache::invalidate(const string& path)
+{
+    auto guard = lock_guard<recursive_mutex>{lock};
+    files.erase(path);
+    if (archive)
+    {
+        loose.insert(path);
+    }
+
+    if (path.compare(0, SHADER_DIRECTORY.size(), SHADER_DIRECTORY) != 0)
+    {
+        return;
+    }
+    const auto name = path.substr(SHADER_DIRECTORY.size());
+    for (auto shader = begin(shaders); shader != end(shaders); )
+    {
+        const auto& includes = shader->second.includes;
+        if (shader->first == name ||
+            find(begin(includes), end(includes), name) != end(includes))
+        {
+            shader = shaders.erase(shader);
+        }
+        else
+        {
+            ++shader;
+        }
+    }
+}
+
+int
+AssetCache::mappedFiles() const
+{
+    auto guard = lock_guard<recursive_mutex>{lock};
+    return count_if(begin(files), end(files), [](const auto& file)
+    {
+        return file.second.file != nullptr;
+    });
+}
+
+const AssetCache::ExpandedShader&
+AssetCache::expand(const string& name, vector<string>& stack)
+{
+    auto guard = lock_guard<recursive_mutex>{lock};
+    auto cached = shaders.find(name);
+    if (cached != end(shaders))
+    {
+        return cached->second;
+    }
+
+    if (find(begin(stack), end(stack), name) != end(stack))
+    {
+        throw FailedToLoadAsset{name, root + "/" + SHADER_DIRECTORY, "it includes itself"};
+    }
+    stack.push_back(name);
+
+    auto file = load(SHADER_DIRECTORY + name).data;
+    auto expanded = ExpandedShader{};
+    auto lineNumber = 0;
+    for (size_t start = 0; start < file.size(); )
+    {
+        auto end = min(file.find('\n', start), file.size());
+        auto line = file.substr(start, end - start);
+        start = end + 1;
+        lineNumber += 1;
+
+        auto includeName = string_view{};
+        if (!includedName(line, includeName))
+        {
+            expanded.source.append(line.data(), line.size()).append("\n");
+            continue;
+        }
+
+        const auto& include = expand(string(includeName), stack);
+        expanded.includes.push_back(string(includeName));
+        expanded.includes.insert(
+            std::end(expanded.includes),
+            std::begin(include.includes),
+            std::end(include.includes)
+        );
+        const auto& text = include.view.data;
+        expanded.source.append(text.data(), text.size());
+        if (!text.empty() && text.back() != '\n')
+        {
+            expanded.source.append("\n");
+        }
+        expanded.source.append("#line " + to_string(lineNumber + 1) + "\n");
+    }
+    stack.pop_back();
+
+    // without includes the mapping can be used as is
+    if (expanded.includes.empty())
+    {
+        expanded.source.clear();
+        expanded.view = load(SHADER_DIRECTORY + name);
+    }
+
+    auto& stored = shaders[name] = move(expanded);
+    if (!stored.includes.empty())
+    {
+        auto data = string_view{stored.source};
+        stored.view = AssetView{data, Fnv1a{}.add(data).value()};
+    }
+    return stored;
+}
+
+AssetCache&
+tetra::assetCache()
+{
+    static AssetCache cache;
+    return cache;
+}
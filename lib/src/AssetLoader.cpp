@@ -0,0 +1,58 @@
+#include <AssetLoader.hpp>
+
+#include <exception>
+#include <utility>
+
+using namespace std;
+using namespace tetra;
+
+AssetLoader::AssetLoader(EventStream& eventStream, AssetCache& cache, int threads)
+    : eventStream{eventStream}
+    , cache{cache}
+    , _pending{0}
+    , workers{threads}
+{ }
+
+AssetLoader::~AssetLoader()
+{
+    // requests which never started will never push their event
+    _pending -= workers.stop();
+}
+
+void
+AssetLoader::load(const string& path)
+{
+    submit(path, [this, path]() { return cache.copy(path); });
+}
+
+void
+AssetLoader::loadShader(const string& name)
+{
+    submit("shaders/" + name, [this, name]() { return cache.copyShader(name); });
+}
+
+int
+AssetLoader::pending() const
+{
+    return _pending.load();
+}
+
+template <class Load>
+void
+AssetLoader::submit(const string& path, Load load)
+{
+    _pending += 1;
+    workers.submit([this, path, load]()
+    {
+        try
+        {
+            auto asset = load();
+            eventStream.push(AssetLoaded{path, move(asset.data), asset.hash});
+        }
+        catch (exception& ex)
+        {
+            eventStream.push(AssetFailed{path, ex.what()});
+        }
+        _pending -= 1;
+    });
+}
@@ -0,0 +1,58 @@
+#include <MappedFile.hpp>
+#include <Assets.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+using namespace std;
+using namespace tetra;
+
+MappedFile::MappedFile(const string& name, const string& path)
+    : address{nullptr}
+    , size{0}
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat info;
+    if (fd == -1 || fstat(fd, &info) == -1)
+    {
+        const auto reason = string{strerror(errno)};
+        if (fd != -1)
+        {
+            close(fd);
+        }
+        throw FailedToLoadAsset{name, path, "file could not be opened, " + reason};
+    }
+
+    // mapping an empty file fails, but an empty view is fine
+    size = info.st_size;
+    if (size > 0)
+    {
+        address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    const auto reason = string{strerror(errno)};
+    close(fd);
+
+    if (address == MAP_FAILED)
+    {
+        throw FailedToLoadAsset{name, path, "file could not be mapped, " + reason};
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (address != nullptr)
+    {
+        munmap(address, size);
+    }
+}
+
+string_view
+MappedFile::data() const
+{
+    return string_view{(const char*)address, size};
+}
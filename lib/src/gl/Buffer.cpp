@@ -26,3 +26,60 @@ tetra::hidden::elementType<GLuint>()
     return GL_UNSIGNED_INT;
 };
 
+void
+DirtyRanges::mark(int first, int count)
+{
+    auto range = Range{first, first + count};
+
+    // find the first range which could touch the new one
+    auto start = lower_bound(begin(_ranges), end(_ranges), range,
+        [](const Range& a, const Range& b) { return a.last < b.first; });
+
+    // merge every range which overlaps or is adjacent to the new one
+    auto stop = start;
+    while (stop != end(_ranges) && stop->first <= range.last)
+    {
+        range.first = min(range.first, stop->first);
+        range.last = max(range.last, stop->last);
+        stop++;
+    }
+
+    start = _ranges.erase(start, stop);
+    _ranges.insert(start, range);
+}
+
+bool
+DirtyRanges::empty() const
+{
+    return _ranges.empty();
+}
+
+const vector<DirtyRanges::Range>&
+DirtyRanges::ranges() const
+{
+    return _ranges;
+}
+
+void
+DirtyRanges::clear()
+{
+    _ranges.clear();
+}
+
+void
+tetra::hidden::waitAndDeleteFence(GLsync fence)
+{
+    constexpr GLuint64 ONE_SECOND = 1000000000;
+    auto result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, ONE_SECOND);
+    while (result == GL_TIMEOUT_EXPIRED)
+    {
+        result = glClientWaitSync(fence, 0, ONE_SECOND);
+    }
+    glDeleteSync(fence);
+
+    if (result == GL_WAIT_FAILED)
+    {
+        THROW_ON_GL_ERROR();
+        throw GLException{"glClientWaitSync failed while waiting on a fence"};
+    }
+}
@@ -0,0 +1,46 @@
+#include <gl/Compute.hpp>
+#include <gl/GLException.hpp>
+#include <gl/GLState.hpp>
+
+using namespace std;
+using namespace tetra;
+
+void
+tetra::memoryBarrier(GLbitfield barriers)
+{
+    glMemoryBarrier(barriers);
+}
+
+array<GLint, 3>
+tetra::workGroupSize(Program& program)
+{
+    auto size = array<GLint, 3>{};
+    glGetProgramiv(program.raw(), GL_COMPUTE_WORK_GROUP_SIZE, size.data());
+    THROW_ON_GL_ERROR();
+    return size;
+}
+
+GLuint
+tetra::groupsFor(int count, GLint groupSize)
+{
+    return (count + groupSize - 1) / groupSize;
+}
+
+void
+tetra::dispatch(Program& program, GLuint groupsX, GLuint groupsY, GLuint groupsZ)
+{
+    program.use();
+    glDispatchCompute(groupsX, groupsY, groupsZ);
+    THROW_ON_GL_ERROR();
+}
+
+void
+tetra::dispatchIndirect(Program& program,
+                        const Buffer<DispatchIndirectCommand>& commands,
+                        int command)
+{
+    program.use();
+    GLState::current().bindBuffer(GL_DISPATCH_INDIRECT_BUFFER, commands.raw());
+    glDispatchComputeIndirect(sizeof(DispatchIndirectCommand) * command);
+    THROW_ON_GL_ERROR();
+}
@@ -0,0 +1,208 @@
+#include <gl/GLState.hpp>
+
+using namespace std;
+using namespace tetra;
+
+namespace
+{
+    GLState* currentState = nullptr;
+
+    /** No valid object name or enum is ~0, so it marks unknown cached state */
+    constexpr GLuint UNKNOWN = ~0u;
+}
+
+GLState::GLState(bool directStateAccess, bool parallelShaderCompile)
+    : _directStateAccess{directStateAccess}
+    , _parallelShaderCompile{parallelShaderCompile}
+{
+    invalidate();
+}
+
+GLState::~GLState()
+{
+    if (currentState == this)
+    {
+        currentState = nullptr;
+    }
+}
+
+bool
+GLState::directStateAccess() const
+{
+    return _directStateAccess;
+}
+
+bool
+GLState::parallelShaderCompile() const
+{
+    return _parallelShaderCompile;
+}
+
+bool
+GLState::changed(bool isDifferent)
+{
+    if (isDifferent)
+    {
+        _counters.issued += 1;
+    }
+    else
+    {
+        _counters.elided += 1;
+    }
+    return isDifferent;
+}
+
+void
+GLState::bindVertexArray(GLuint vao)
+{
+    if (changed(vertexArray != vao))
+    {
+        glBindVertexArray(vao);
+        vertexArray = vao;
+
+        // the element array binding is part of the vao's state
+        buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+    }
+}
+
+void
+GLState::useProgram(GLuint program)
+{
+    if (changed(this->program != program))
+    {
+        glUseProgram(program);
+        this->program = program;
+    }
+}
+
+void
+GLState::bindBuffer(GLenum target, GLuint buffer)
+{
+    auto bound = buffers.find(target);
+    if (changed(bound == end(buffers) || bound->second != buffer))
+    {
+        glBindBuffer(target, buffer);
+        buffers[target] = buffer;
+    }
+}
+
+void
+GLState::bindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+    _counters.issued += 1;
+    glBindBufferBase(target, index, buffer);
+    buffers[target] = buffer;
+}
+
+void
+GLState::bindBufferRange(GLenum target, GLuint index, GLuint buffer,
+                         GLintptr offset, GLsizeiptr size)
+{
+    _counters.issued += 1;
+    glBindBufferRange(target, index, buffer, offset, size);
+    buffers[target] = buffer;
+}
+
+void
+GLState::blend(bool enabled)
+{
+    auto flag = enabled ? Flag::Enabled : Flag::Disabled;
+    if (changed(blending != flag))
+    {
+        if (enabled)
+        {
+            glEnable(GL_BLEND);
+        }
+        else
+        {
+            glDisable(GL_BLEND);
+        }
+        blending = flag;
+    }
+}
+
+void
+GLState::blendFunc(GLenum source, GLenum destination)
+{
+    auto function = array<GLenum, 2>{source, destination};
+    if (changed(blendFunction != function))
+    {
+        glBlendFunc(source, destination);
+        blendFunction = function;
+    }
+}
+
+void
+GLState::viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    auto rect = array<GLint, 4>{x, y, width, height};
+    if (changed(_viewport != rect))
+    {
+        glViewport(x, y, width, height);
+        _viewport = rect;
+    }
+}
+
+void
+GLState::forgetVertexArray(GLuint vao)
+{
+    if (vertexArray == vao)
+    {
+        vertexArray = UNKNOWN;
+        buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+    }
+}
+
+void
+GLState::forgetProgram(GLuint program)
+{
+    if (this->program == program)
+    {
+        this->program = UNKNOWN;
+    }
+}
+
+void
+GLState::forgetBuffer(GLuint buffer)
+{
+    for (auto bound = begin(buffers); bound != end(buffers);)
+    {
+        bound = bound->second == buffer ? buffers.erase(bound) : next(bound);
+    }
+}
+
+void
+GLState::invalidate()
+{
+    vertexArray = UNKNOWN;
+    program = UNKNOWN;
+    buffers.clear();
+    blending = Flag::Unknown;
+    blendFunction = {UNKNOWN, UNKNOWN};
+    _viewport = {-1, -1, -1, -1};
+}
+
+const GLState::Counters&
+GLState::counters() const
+{
+    return _counters;
+}
+
+void
+GLState::resetCounters()
+{
+    _counters = Counters{};
+}
+
+void
+GLState::makeCurrent()
+{
+    currentState = this;
+}
+
+GLState&
+GLState::current()
+{
+    static GLState fallback{false};
+    return currentState != nullptr ? *currentState : fallback;
+}
@@ -1,5 +1,6 @@
 #include <gl/Program.hpp>
 #include <gl/GLException.hpp>
+#include <gl/GLState.hpp>
 
 #include <glm/gtc/type_ptr.hpp>
 
@@ -20,6 +21,18 @@ tetra::uniforms::uniformValue(GLint location, float f)
     glUniform1f(location, f);
 }
 
+void
+tetra::uniforms::uniformValue(GLint location, int i)
+{
+    glUniform1i(location, i);
+}
+
+void
+tetra::uniforms::uniformValue(GLint location, unsigned int u)
+{
+    glUniform1ui(location, u);
+}
+
 void
 tetra::uniforms::uniformValue(GLint location, const array<float, 1>& vec)
 {
@@ -58,15 +71,27 @@ Program::Program()
 Program::Program(Program&& from)
     : shouldDelete{from.shouldDelete}
     , handle{from.handle}
+    , uniforms{move(from.uniforms)}
 {
     // Don't let 'from' delete my program now that I own it!
     from.shouldDelete = false;
 }
 
+Program&
+Program::operator=(Program&& from)
+{
+    // 'from' deletes the old program when it goes out of scope
+    swap(shouldDelete, from.shouldDelete);
+    swap(handle, from.handle);
+    swap(uniforms, from.uniforms);
+    return *this;
+}
+
 Program::~Program()
 {
     if (shouldDelete)
     {
+        GLState::current().forgetProgram(handle);
         glDeleteProgram(handle);
         shouldDelete = false;
     }
@@ -81,13 +106,109 @@ Program::raw()
 void
 Program::use()
 {
-    glUseProgram(handle);
+    GLState::current().useProgram(handle);
 }
 
 GLint
-Program::uniformLocation(const string& uniform)
+Program::uniformLocation(const string& uniform) const
+{
+    auto found = uniforms.find(uniform);
+    if (found != end(uniforms))
+    {
+        return found->second;
+    }
+
+    // names introspection doesn't list, e.g. "lights[2]" or "light.colour",
+    // are asked of the GL once and remembered, including misses
+    auto location = glGetUniformLocation(handle, uniform.c_str());
+    uniforms[uniform] = location;
+    return location;
+}
+
+void
+Program::introspectUniforms()
+{
+    GLint count, maxLength;
+    glGetProgramiv(handle, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(handle, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    auto name = vector<GLchar>(maxLength + 1);
+    uniforms.clear();
+    uniforms.reserve(count);
+    for (GLint index = 0; index < count; index++)
+    {
+        GLsizei length;
+        GLint size;
+        GLenum type;
+        glGetActiveUniform(handle, index, name.size(), &length, &size, &type, name.data());
+
+        auto uniform = string(name.data(), length);
+        auto location = glGetUniformLocation(handle, uniform.c_str());
+        if (location == -1)
+        {
+            // uniforms in blocks have no location
+            continue;
+        }
+        uniforms[uniform] = location;
+
+        // arrays are reported as "name[0]", but are commonly looked up as "name"
+        const auto arraySuffix = string("[0]");
+        if (uniform.size() > arraySuffix.size() &&
+            uniform.compare(uniform.size() - arraySuffix.size(),
+                            arraySuffix.size(), arraySuffix) == 0)
+        {
+            uniforms[uniform.substr(0, uniform.size() - arraySuffix.size())] = location;
+        }
+    }
+    THROW_ON_GL_ERROR();
+}
+
+int
+Program::feedbackStride()
 {
-    return glGetUniformLocation(handle, uniform.c_str());
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(handle, GL_TRANSFORM_FEEDBACK_VARYINGS, &count);
+    glGetProgramiv(handle, GL_TRANSFORM_FEEDBACK_VARYING_MAX_LENGTH, &maxLength);
+
+    auto name = vector<GLchar>(maxLength + 1);
+    int stride = 0;
+    for (GLint index = 0; index < count; index++)
+    {
+        GLsizei length;
+        GLsizei size;
+        GLenum type;
+        glGetTransformFeedbackVarying(handle, index, name.size(), &length, &size, &type, name.data());
+
+        int bytes;
+        switch (type)
+        {
+        // gl_SkipComponents* report no type and their component count as size
+        case GL_NONE: bytes = 4; break;
+        case GL_FLOAT: case GL_INT: case GL_UNSIGNED_INT: bytes = 4; break;
+        case GL_FLOAT_VEC2: case GL_INT_VEC2: case GL_UNSIGNED_INT_VEC2: bytes = 8; break;
+        case GL_FLOAT_VEC3: case GL_INT_VEC3: case GL_UNSIGNED_INT_VEC3: bytes = 12; break;
+        case GL_FLOAT_VEC4: case GL_INT_VEC4: case GL_UNSIGNED_INT_VEC4: bytes = 16; break;
+        case GL_FLOAT_MAT2: bytes = 16; break;
+        case GL_FLOAT_MAT3: bytes = 36; break;
+        case GL_FLOAT_MAT4: bytes = 64; break;
+        case GL_FLOAT_MAT2x3: case GL_FLOAT_MAT3x2: bytes = 24; break;
+        case GL_FLOAT_MAT2x4: case GL_FLOAT_MAT4x2: bytes = 32; break;
+        case GL_FLOAT_MAT3x4: case GL_FLOAT_MAT4x3: bytes = 48; break;
+        case GL_DOUBLE: bytes = 8; break;
+        case GL_DOUBLE_VEC2: bytes = 16; break;
+        case GL_DOUBLE_VEC3: bytes = 24; break;
+        case GL_DOUBLE_VEC4: bytes = 32; break;
+        default:
+            throw GLException{ "Transform feedback varying"
+                             , string(name.data(), length)
+                             , "has an unsupported type"
+                             , to_string(type)
+                             };
+        }
+        stride += bytes * size;
+    }
+    THROW_ON_GL_ERROR();
+    return stride;
 }
 
 ProgramLinker&
@@ -97,6 +218,13 @@ ProgramLinker::vertexAttributes(const vector<string>& attribs)
     return *this;
 }
 
+ProgramLinker&
+ProgramLinker::feedbackVaryings(const vector<string>& varyings)
+{
+    _feedbackVaryings = varyings;
+    return *this;
+}
+
 ProgramLinker&
 ProgramLinker::attach(Shader& shader)
 {
@@ -104,24 +232,50 @@ ProgramLinker::attach(Shader& shader)
     return *this;
 }
 
-Program
-ProgramLinker::link()
+ProgramLinker&
+ProgramLinker::source(ShaderType type, const string& source)
 {
-    auto program = Program{};
+    _sources.emplace_back(type, source);
+    return *this;
+}
 
-    for (auto shader : _shaders)
+ProgramLinker&
+ProgramLinker::cache(ProgramCache& cache)
+{
+    _cache = &cache;
+    return *this;
+}
+
+PendingProgram::PendingProgram(Program&& program)
+    : program{move(program)}
+{ }
+
+bool
+PendingProgram::ready()
+{
+    if (linked || !GLState::current().parallelShaderCompile())
     {
-        glAttachShader(program.raw(), shader->raw());
+        return true;
     }
 
-    const int size = _vertexAttributes.size();
-    for (int idx = 0; idx < size; idx++)
+    GLint complete;
+    glGetProgramiv(program.raw(), GL_COMPLETION_STATUS_KHR, &complete);
+    return complete == GL_TRUE;
+}
+
+Program
+PendingProgram::get()
+{
+    if (linked)
     {
-        auto attrib = _vertexAttributes[idx].c_str();
-        glBindAttribLocation(program.raw(), idx, attrib);
+        return move(program);
     }
 
-    glLinkProgram(program.raw());
+    // compile errors are more useful than the link error they cause
+    for (auto& shader : shaders)
+    {
+        shader.checkCompiled();
+    }
 
     GLint linkSuccessful;
     glGetProgramiv(program.raw(), GL_LINK_STATUS, &linkSuccessful);
@@ -134,7 +288,106 @@ ProgramLinker::link()
                          };
     }
 
-    return program;
+    // shaders only need to live until the program is linked
+    shaders.clear();
+    if (cache != nullptr)
+    {
+        cache->store(program.raw(), key);
+    }
+
+    program.introspectUniforms();
+    linked = true;
+    return move(program);
+}
+
+PendingProgram
+ProgramLinker::submit()
+{
+    auto pending = PendingProgram{Program{}};
+    auto& program = pending.program;
+
+    const int size = _vertexAttributes.size();
+    for (int idx = 0; idx < size; idx++)
+    {
+        auto attrib = _vertexAttributes[idx].c_str();
+        glBindAttribLocation(program.raw(), idx, attrib);
+    }
+
+    if (!_feedbackVaryings.empty())
+    {
+        auto varyings = vector<const char*>{};
+        for (const auto& varying : _feedbackVaryings)
+        {
+            varyings.push_back(varying.c_str());
+        }
+        glTransformFeedbackVaryings(
+            program.raw(), varyings.size(), varyings.data(), GL_INTERLEAVED_ATTRIBS
+        );
+    }
+
+    const bool cacheable = _cache != nullptr && _shaders.empty() && _cache->enabled();
+    auto key = string{};
+    if (cacheable)
+    {
+        // the captured varyings are baked into the binary, so they're part of the key
+        auto bindings = _vertexAttributes;
+        for (const auto& varying : _feedbackVaryings)
+        {
+            bindings.push_back("feedback " + varying);
+        }
+        key = _cache->key(_sources, bindings);
+        if (_cache->load(program.raw(), key))
+        {
+            program.introspectUniforms();
+            pending.linked = true;
+            return pending;
+        }
+        glProgramParameteri(program.raw(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        pending.cache = _cache;
+        pending.key = key;
+    }
+
+    for (auto shader : _shaders)
+    {
+        glAttachShader(program.raw(), shader->raw());
+    }
+
+    // nothing here waits on the driver, the results are checked in get()
+    pending.shaders.reserve(_sources.size());
+    for (const auto& source : _sources)
+    {
+        pending.shaders.emplace_back(source.first);
+        pending.shaders.back().submit(source.second);
+        glAttachShader(program.raw(), pending.shaders.back().raw());
+    }
+
+    glLinkProgram(program.raw());
+    return pending;
+}
+
+Program
+ProgramLinker::link()
+{
+    return submit().get();
+}
+
+vector<Program>
+tetra::linkAll(vector<ProgramLinker>& linkers)
+{
+    auto pending = vector<PendingProgram>{};
+    pending.reserve(linkers.size());
+    for (auto& linker : linkers)
+    {
+        pending.push_back(linker.submit());
+    }
+
+    auto programs = vector<Program>{};
+    programs.reserve(pending.size());
+    for (auto& program : pending)
+    {
+        programs.push_back(program.get());
+    }
+    return programs;
 }
 
 
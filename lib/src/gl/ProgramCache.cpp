@@ -0,0 +1,122 @@
+#include <gl/ProgramCache.hpp>
+#include <tetra/Fnv1a.hpp>
+#include <AssetRoot.h>
+
+#include <fstream>
+
+using namespace std;
+using namespace tetra;
+
+namespace
+{
+    string glString(GLenum name)
+    {
+        auto value = glGetString(name);
+        return value != nullptr ? string((const char*)value) : string();
+    }
+}
+
+ProgramCache::ProgramCache(const string& directory)
+    : directory{directory}
+{ }
+
+string
+ProgramCache::key(const Sources& sources, const vector<string>& attributes) const
+{
+    auto hash = Fnv1a{};
+    hash.add(glString(GL_VENDOR))
+        .add(glString(GL_RENDERER))
+        .add(glString(GL_VERSION));
+
+    for (const auto& source : sources)
+    {
+        hash.add(to_string(source.first)).add(source.second);
+    }
+    for (const auto& attribute : attributes)
+    {
+        hash.add(attribute);
+    }
+    return hash.hex();
+}
+
+bool
+ProgramCache::enabled() const
+{
+    if (formats < 0)
+    {
+        formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    }
+    return formats > 0;
+}
+
+bool
+ProgramCache::load(GLuint program, const string& key) const
+{
+    if (!enabled())
+    {
+        return false;
+    }
+
+    ifstream file(path(key), ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    GLenum format;
+    file.read((char*)&format, sizeof(format));
+    auto binary = vector<char>(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    if (!file.good() && !file.eof())
+    {
+        return false;
+    }
+
+    glProgramBinary(program, format, binary.data(), binary.size());
+
+    // drivers reject binaries from other versions by failing the link
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    glGetError(); // a rejected binary can raise an error, we just fall back
+    return linked == GL_TRUE;
+}
+
+void
+ProgramCache::store(GLuint program, const string& key) const
+{
+    if (!enabled())
+    {
+        return;
+    }
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+    {
+        return;
+    }
+
+    GLenum format;
+    auto binary = vector<char>(length);
+    glGetProgramBinary(program, length, nullptr, &format, binary.data());
+    if (glGetError() != GL_NO_ERROR)
+    {
+        return;
+    }
+
+    ofstream file(path(key), ios::binary | ios::trunc);
+    file.write((const char*)&format, sizeof(format));
+    file.write(binary.data(), binary.size());
+}
+
+string
+ProgramCache::defaultDirectory()
+{
+    return PROGRAM_CACHE_ROOT;
+}
+
+string
+ProgramCache::path(const string& key) const
+{
+    return directory + "/" + key + ".bin";
+}
@@ -0,0 +1,114 @@
+#include <gl/ProgramLibrary.hpp>
+#include <Assets.hpp>
+#include <AssetCache.hpp>
+
+#include <algorithm>
+
+#include <exception>
+#include <iostream>
+
+using namespace std;
+using namespace tetra;
+
+ProgramLibrary::ProgramLibrary(EventStream& eventStream, ProgramCache* cache)
+    : eventStream{eventStream}
+    , cache{cache}
+    , listener{eventStream.addListener(*this, &ProgramLibrary::onAssetChanged)}
+{ }
+
+Program&
+ProgramLibrary::add(const vector<string>& vertexAttributes,
+                    const ShaderFiles& shaderFiles,
+                    Setup setup)
+{
+    auto program = build(vertexAttributes, shaderFiles);
+    if (setup)
+    {
+        setup(program);
+    }
+
+    auto entry = unique_ptr<Entry>{
+        new Entry{vertexAttributes, shaderFiles, setup, move(program)}
+    };
+
+    addDependencies(entry.get());
+    entries.push_back(move(entry));
+    return entries.back()->program;
+}
+
+void
+ProgramLibrary::onAssetChanged(const AssetChanged& changed)
+{
+    if (changed.directory != "shaders")
+    {
+        return;
+    }
+
+    assetCache().invalidate(changed.directory + "/" + changed.name);
+    auto found = dependents.find(changed.name);
+    if (found == end(dependents))
+    {
+        return;
+    }
+
+    // rebuilding can add dependencies, so don't iterate the live list
+    const auto affected = found->second;
+    for (auto entry : affected)
+    {
+        try
+        {
+            auto program = build(entry->vertexAttributes, entry->shaderFiles);
+            if (entry->setup)
+            {
+                entry->setup(program);
+            }
+            entry->program = move(program);
+            addDependencies(entry);
+            eventStream.push(ProgramReloaded{&entry->program});
+            cout << "reloaded program using " << changed.name << endl;
+        }
+        catch (exception& ex)
+        {
+            cout << "keeping the previous program, " << ex.what() << endl;
+        }
+    }
+}
+
+void
+ProgramLibrary::addDependencies(Entry* entry)
+{
+    auto depend = [&](const string& name)
+    {
+        auto& programs = dependents[name];
+        if (find(begin(programs), end(programs), entry) == end(programs))
+        {
+            programs.push_back(entry);
+        }
+    };
+
+    for (const auto& file : entry->shaderFiles)
+    {
+        depend(file.second);
+        for (const auto& include : assetCache().includes(file.second))
+        {
+            depend(include);
+        }
+    }
+}
+
+Program
+ProgramLibrary::build(const vector<string>& vertexAttributes,
+                      const ShaderFiles& shaderFiles)
+{
+    auto linker = ProgramLinker{};
+    linker.vertexAttributes(vertexAttributes);
+    for (const auto& file : shaderFiles)
+    {
+        linker.source(file.first, loadShaderSrc(file.second));
+    }
+    if (cache != nullptr)
+    {
+        linker.cache(*cache);
+    }
+    return linker.link();
+}
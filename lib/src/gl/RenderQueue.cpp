@@ -0,0 +1,271 @@
+#include <gl/RenderQueue.hpp>
+#include <gl/GLException.hpp>
+#include <gl/GLState.hpp>
+
+#include <algorithm>
+#include <array>
+#include <string>
+
+using namespace std;
+using namespace tetra;
+
+namespace
+{
+    constexpr int DEPTH_SHIFT = 0;
+    constexpr int BLEND_SHIFT = DEPTH_SHIFT + RenderQueue::DEPTH_BITS;
+    constexpr int VAO_SHIFT = BLEND_SHIFT + RenderQueue::BLEND_BITS;
+    constexpr int PROGRAM_SHIFT = VAO_SHIFT + RenderQueue::VAO_BITS;
+    constexpr int LAYER_SHIFT = PROGRAM_SHIFT + RenderQueue::PROGRAM_BITS;
+    static_assert(LAYER_SHIFT + RenderQueue::LAYER_BITS == 64,
+                  "the sort key fields must fill 64 bits");
+
+    constexpr uint64_t mask(int bits)
+    {
+        return (uint64_t{1} << bits) - 1;
+    }
+
+    int field(uint64_t key, int shift, int bits)
+    {
+        return (key >> shift) & mask(bits);
+    }
+
+    template <class Object>
+    int registerId(const Object* object,
+                   unordered_map<const Object*, int>& ids,
+                   vector<Object*>& objects,
+                   int bits,
+                   const char* kind)
+    {
+        auto found = ids.find(object);
+        if (found != end(ids))
+        {
+            return found->second;
+        }
+        if (objects.size() > mask(bits))
+        {
+            throw GLException{ "RenderQueue sort keys can't hold more than"
+                             , to_string(mask(bits) + 1)
+                             , kind
+                             };
+        }
+
+        int id = objects.size();
+        objects.push_back(const_cast<Object*>(object));
+        ids[object] = id;
+        return id;
+    }
+
+    /**
+     * Stable least significant digit radix sort on the keys, one byte per pass.
+     * All eight histograms are built in one read of the input, and passes where
+     * every key has the same byte (e.g. the layer in a single layer frame) are
+     * skipped entirely.
+     */
+    template <class Entry>
+    void radixSort(vector<Entry>& entries, vector<Entry>& scratch)
+    {
+        constexpr int DIGITS = 8;
+        constexpr int RADIX = 256;
+
+        auto counts = array<array<uint32_t, RADIX>, DIGITS>{};
+        for (const auto& entry : entries)
+        {
+            for (int digit = 0; digit < DIGITS; digit++)
+            {
+                counts[digit][(entry.key >> (8*digit)) & 0xFF] += 1;
+            }
+        }
+
+        scratch.resize(entries.size());
+        for (int digit = 0; digit < DIGITS; digit++)
+        {
+            auto& count = counts[digit];
+            auto first = (entries.front().key >> (8*digit)) & 0xFF;
+            if (count[first] == entries.size())
+            {
+                continue;
+            }
+
+            uint32_t offset = 0;
+            for (auto& bucket : count)
+            {
+                auto size = bucket;
+                bucket = offset;
+                offset += size;
+            }
+            for (const auto& entry : entries)
+            {
+                scratch[count[(entry.key >> (8*digit)) & 0xFF]++] = entry;
+            }
+            entries.swap(scratch);
+        }
+    }
+}
+
+bool
+BlendState::operator==(const BlendState& other) const
+{
+    if (!enabled || !other.enabled)
+    {
+        return enabled == other.enabled;
+    }
+    return source == other.source && destination == other.destination;
+}
+
+RenderQueue::RenderQueue()
+    : blendStates{BlendState{false, GL_ONE, GL_ZERO}}
+{ }
+
+int
+RenderQueue::blendState(const BlendState& state)
+{
+    auto found = find(begin(blendStates), end(blendStates), state);
+    if (found != end(blendStates))
+    {
+        return found - begin(blendStates);
+    }
+    if (blendStates.size() > mask(BLEND_BITS))
+    {
+        throw GLException{ "RenderQueue sort keys can't hold more than"
+                         , to_string(mask(BLEND_BITS) + 1)
+                         , "blend states"
+                         };
+    }
+
+    blendStates.push_back(state);
+    return blendStates.size() - 1;
+}
+
+uint64_t
+RenderQueue::key(int layer, Program& program, const Vao& vao, int blend, float depth)
+{
+    if (layer < 0 || (uint64_t)layer > mask(LAYER_BITS))
+    {
+        throw GLException{ "RenderQueue layer"
+                         , to_string(layer)
+                         , "is outside 0 to"
+                         , to_string(mask(LAYER_BITS))
+                         };
+    }
+    if (blend < 0 || (size_t)blend >= blendStates.size())
+    {
+        throw GLException{ "RenderQueue blend state"
+                         , to_string(blend)
+                         , "was not returned by blendState()"
+                         };
+    }
+
+    const uint64_t programId =
+        registerId<Program>(&program, programIds, programs, PROGRAM_BITS, "programs");
+    const uint64_t vaoId =
+        registerId<const Vao>(&vao, vaoIds, vaos, VAO_BITS, "vaos");
+    const uint64_t depthBits = clamp(depth, 0.0f, 1.0f) * mask(DEPTH_BITS);
+
+    return (uint64_t)layer << LAYER_SHIFT
+         | programId << PROGRAM_SHIFT
+         | vaoId << VAO_SHIFT
+         | (uint64_t)blend << BLEND_SHIFT
+         | depthBits << DEPTH_SHIFT;
+}
+
+void
+RenderQueue::submit(uint64_t key, const DrawCall& draw)
+{
+    entries.push_back({key, (uint32_t)commands.size()});
+    commands.push_back({draw, {}});
+}
+
+void
+RenderQueue::submit(uint64_t key, function<void()> draw)
+{
+    entries.push_back({key, (uint32_t)commands.size()});
+    commands.push_back({DrawCall{}, move(draw)});
+}
+
+RenderQueue::Stats
+RenderQueue::flush(bool sort)
+{
+    if (sort && !entries.empty())
+    {
+        radixSort(entries, scratch);
+    }
+
+    auto stats = execute();
+    entries.clear();
+    commands.clear();
+    return stats;
+}
+
+int
+RenderQueue::queued() const
+{
+    return entries.size();
+}
+
+RenderQueue::Stats
+RenderQueue::execute()
+{
+    auto stats = Stats{};
+    auto& state = GLState::current();
+    int program = -1;
+    int vao = -1;
+    int blend = -1;
+
+    for (const auto& entry : entries)
+    {
+        const int nextProgram = field(entry.key, PROGRAM_SHIFT, PROGRAM_BITS);
+        if (nextProgram != program)
+        {
+            programs[nextProgram]->use();
+            program = nextProgram;
+            stats.programChanges += 1;
+        }
+
+        const int nextVao = field(entry.key, VAO_SHIFT, VAO_BITS);
+        if (nextVao != vao)
+        {
+            vaos[nextVao]->bind();
+            vao = nextVao;
+            stats.vaoChanges += 1;
+        }
+
+        const int nextBlend = field(entry.key, BLEND_SHIFT, BLEND_BITS);
+        if (nextBlend != blend)
+        {
+            const auto& blendState = blendStates[nextBlend];
+            state.blend(blendState.enabled);
+            if (blendState.enabled)
+            {
+                state.blendFunc(blendState.source, blendState.destination);
+            }
+            blend = nextBlend;
+            stats.blendChanges += 1;
+        }
+
+        const auto& command = commands[entry.command];
+        const auto& draw = command.draw;
+        if (command.callback)
+        {
+            command.callback();
+        }
+        else if (draw.indexType == GL_NONE)
+        {
+            glDrawArraysInstanced(draw.primitive, draw.first, draw.count, draw.instances);
+        }
+        else
+        {
+            const auto indexSize = draw.indexType == GL_UNSIGNED_BYTE ? 1
+                                 : draw.indexType == GL_UNSIGNED_SHORT ? 2
+                                 : 4;
+            glDrawElementsInstancedBaseVertex(
+                draw.primitive, draw.count, draw.indexType,
+                (const GLvoid*)(intptr_t)(draw.first * indexSize),
+                draw.instances, draw.baseVertex
+            );
+        }
+        stats.draws += 1;
+    }
+    THROW_ON_GL_ERROR();
+
+    return stats;
+}
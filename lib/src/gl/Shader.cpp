@@ -1,7 +1,10 @@
 #include <gl/Shader.hpp>
 #include <gl/GLException.hpp>
+#include <gl/GLState.hpp>
 #include <GL/glew.h>
 
+#include <vector>
+
 using namespace tetra;
 using namespace std;
 
@@ -35,13 +38,37 @@ Shader::~Shader()
 
 void
 Shader::compile(const string& source)
+{
+    submit(source);
+    checkCompiled();
+}
+
+void
+Shader::submit(const string& source)
 {
     GLchar* sourceStrPtr[1];
     sourceStrPtr[0] = (GLchar *)source.c_str();
 
     glShaderSource(handle, 1, (const GLchar**)sourceStrPtr, nullptr);
     glCompileShader(handle);
+}
+
+bool
+Shader::completed()
+{
+    if (!GLState::current().parallelShaderCompile())
+    {
+        return true;
+    }
+
+    GLint complete;
+    glGetShaderiv(handle, GL_COMPLETION_STATUS_KHR, &complete);
+    return complete == GL_TRUE;
+}
 
+void
+Shader::checkCompiled()
+{
     GLint compileSuccess;
     glGetShaderiv(handle, GL_COMPILE_STATUS, &compileSuccess);
 
@@ -49,11 +76,17 @@ Shader::compile(const string& source)
     {
         char infoLog[LOG_LENGTH];
         glGetShaderInfoLog(handle, LOG_LENGTH, NULL, infoLog);
+
+        GLint sourceLength;
+        glGetShaderiv(handle, GL_SHADER_SOURCE_LENGTH, &sourceLength);
+        auto source = vector<GLchar>(sourceLength + 1);
+        glGetShaderSource(handle, source.size(), NULL, source.data());
+
         throw GLException({ "Error while compiling shader!"
                           , "\n"
                           , infoLog
                           , "\n"
-                          , source
+                          , source.data()
                           });
     }
 }
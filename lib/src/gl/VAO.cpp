@@ -13,6 +13,7 @@ Vao::~Vao()
 {
     if (shouldDelete)
     {
+        GLState::current().forgetVertexArray(handle);
         glDeleteVertexArrays(1, &handle);
         shouldDelete = false;
     }
@@ -34,5 +35,5 @@ Vao::raw() const
 void
 Vao::bind() const
 {
-    glBindVertexArray(handle);
+    GLState::current().bindVertexArray(handle);
 }
@@ -51,6 +51,7 @@ Builder::Builder(SDL_Window* window)
     : _majorVersion{3}
     , _minorVersion{1}
     , _profileMask{SDL_GL_CONTEXT_PROFILE_CORE}
+    , _directStateAccess{true}
     , _window{window}
 { }
 
@@ -75,6 +76,13 @@ Builder::profileMask(int mask)
     return *this;
 }
 
+Builder&
+Builder::directStateAccess(bool enabled)
+{
+    _directStateAccess = enabled;
+    return *this;
+}
+
 GLContext
 Builder::build()
 {
@@ -95,6 +103,29 @@ Builder::build()
 
     auto context = GLContext{rawContext};
     initGlew(context);
+
+    const bool dsaSupported = GLEW_VERSION_4_5 || GLEW_ARB_direct_state_access;
+
+    // let the driver pick how many compiler threads to use
+    const GLuint driverChoosesThreads = 0xFFFFFFFF;
+    bool parallelShaderCompile = true;
+    if (GLEW_KHR_parallel_shader_compile)
+    {
+        glMaxShaderCompilerThreadsKHR(driverChoosesThreads);
+    }
+    else if (GLEW_ARB_parallel_shader_compile)
+    {
+        glMaxShaderCompilerThreadsARB(driverChoosesThreads);
+    }
+    else
+    {
+        parallelShaderCompile = false;
+    }
+
+    context._state.reset(new GLState{ _directStateAccess && dsaSupported
+                                    , parallelShaderCompile
+                                    });
+    context._state->makeCurrent();
     return context;
 }
 
@@ -107,6 +138,7 @@ GLContext::GLContext(SDL_GLContext context)
 
 GLContext::GLContext(GLContext&& from)
     : context{from.context}
+    , _state{move(from._state)}
 {
     from.context = NULL;
 }
@@ -119,3 +151,9 @@ GLContext::~GLContext()
         context = NULL;
     }
 }
+
+GLState&
+GLContext::state()
+{
+    return *_state;
+}
@@ -11,6 +11,11 @@ SDL::SDL(EventStream& eventStream)
 {
     SDL_Init(SDL_INIT_EVERYTHING);
     this->shouldDestroySDL = true;
+
+    // SDL can report many motion and resize events per frame, but listeners
+    // only care about where things ended up.
+    eventStream.coalesce<SDLMousePosition>(accumulateMotion);
+    eventStream.keepLatest<SDLWindowSize>();
 }
 
 SDL::SDL(SDL&& from)
@@ -2,6 +2,7 @@
 #include <sdl/SDLException.hpp>
 #include <sdl/SDL.hpp>
 #include <sdl/SDLEvents.hpp>
+#include <gl/GLState.hpp>
 
 #include <GL/glew.h>
 #include <SDL.h>
@@ -78,9 +79,11 @@ Frame::Frame(SDLWindow& window)
     : window{window}
     , completed{false}
 {
+    GLState::current().resetCounters();
+
     int w, h;
     SDL_GL_GetDrawableSize(window.raw(), &w, &h);
-    glViewport(0, 0, w, h);
+    GLState::current().viewport(0, 0, w, h);
 }
 
 Frame::Frame(Frame&& from)
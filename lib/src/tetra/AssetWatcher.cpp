@@ -0,0 +1,76 @@
+#include <tetra/AssetWatcher.hpp>
+#include <Assets.hpp>
+#include <AssetRoot.h>
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+using namespace std;
+using namespace tetra;
+
+namespace
+{
+    /** How long the watcher sleeps before checking if it should stop */
+    constexpr int POLL_TIMEOUT_MILLIS = 100;
+
+    /** Saving in place closes the file, saving via a temp file renames it */
+    constexpr uint32_t SAVED = IN_CLOSE_WRITE | IN_MOVED_TO;
+}
+
+AssetWatcher::AssetWatcher(EventStream& eventStream, const string& directory)
+    : eventStream{eventStream}
+    , directory{directory}
+    , inotify{inotify_init1(IN_NONBLOCK | IN_CLOEXEC)}
+    , running{true}
+{
+    const auto path = string(ASSET_ROOT) + "/" + directory;
+    if (inotify == -1 || inotify_add_watch(inotify, path.c_str(), SAVED) == -1)
+    {
+        const auto reason = string{strerror(errno)};
+        if (inotify != -1)
+        {
+            close(inotify);
+        }
+        throw FailedToLoadAsset{directory, path, "it cannot be watched, " + reason};
+    }
+
+    eventStream.dropDuplicates<AssetChanged>();
+    watcher = thread{[this]() { watch(); }};
+}
+
+AssetWatcher::~AssetWatcher()
+{
+    running.store(false);
+    watcher.join();
+    close(inotify);
+}
+
+void
+AssetWatcher::watch()
+{
+    alignas(inotify_event) char buffer[4096];
+    auto request = pollfd{inotify, POLLIN, 0};
+
+    while (running.load())
+    {
+        if (poll(&request, 1, POLL_TIMEOUT_MILLIS) <= 0)
+        {
+            continue;
+        }
+
+        const auto length = read(inotify, buffer, sizeof(buffer));
+        for (auto offset = 0l; offset < length; )
+        {
+            auto event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            if (event->len > 0 && (event->mask & SAVED))
+            {
+                eventStream.push(AssetChanged{directory, event->name});
+            }
+            offset += sizeof(inotify_event) + event->len;
+        }
+    }
+}
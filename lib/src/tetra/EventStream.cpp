@@ -4,7 +4,6 @@
 
 using namespace tetra;
 using namespace std;
-using namespace boost;
 
 using AutoRemoveListener = EventStream::AutoRemoveListener;
 using ObserverId = EventStream::ObserverId;
@@ -32,25 +31,69 @@ AutoRemoveListener::~AutoRemoveListener()
 }
 
 EventStream::EventStream(int maxEventsPerUpdate)
-    : maxEventsPerUpdate{maxEventsPerUpdate}
+    : owner{this_thread::get_id()}
+    , maxEventsPerUpdate{maxEventsPerUpdate}
 { }
 
 void
-EventStream::push(boost::any event)
+EventStream::push(Event event)
 {
-    events.push_back(event);
+    if (this_thread::get_id() == owner)
+    {
+        enqueue(std::move(event));
+    }
+    else
+    {
+        incoming.push(std::move(event));
+    }
+}
+
+void
+EventStream::enqueue(Event event)
+{
+    auto coalescer = coalescers.find(event.type());
+    if (coalescer != end(coalescers))
+    {
+        auto& state = coalescer->second;
+        if (state.lastQueued > dispatchedCount)
+        {
+            // the last event of this type is still queued, try to merge into it
+            auto& pending = events[state.lastQueued - 1 - dispatchedCount];
+            if (state.merge(pending, event))
+            {
+                return;
+            }
+        }
+        state.lastQueued = pushedCount + 1;
+    }
+
+    events.push(std::move(event));
+    pushedCount += 1;
 }
 
 void
 EventStream::dispatch()
 {
+    // bring in everything other threads have pushed since the last dispatch
+    auto event = Event{};
+    while (incoming.pop(event))
+    {
+        enqueue(std::move(event));
+    }
+
     for(int count = 0; count < maxEventsPerUpdate && !events.empty(); count++)
     {
-        for (const auto& listener : listeners)
+        // Pop before notifying so listeners can safely push new events.
+        event = events.pop();
+        dispatchedCount += 1;
+        auto bucket = listeners.find(event.type());
+        if (bucket != end(listeners))
         {
-            listener.second(events[0]);
+            for (const auto& listener : bucket->second)
+            {
+                listener.second(event);
+            }
         }
-        events.erase(events.begin());
     }
 }
 
@@ -64,11 +107,15 @@ EventStream::nextId()
 void
 EventStream::remove(ObserverId id)
 {
-    listeners.erase(remove_if(begin(listeners), end(listeners),
-        [&](std::pair<ObserverId, Listener>& handler) {
-            return handler.first == id;
-        }),
-        end(listeners)
-    );
+    // Removal is rare compared to dispatch, so just search every bucket.
+    for (auto& bucket : listeners)
+    {
+        auto& handlers = bucket.second;
+        handlers.erase(remove_if(begin(handlers), end(handlers),
+            [&](std::pair<ObserverId, Listener>& handler) {
+                return handler.first == id;
+            }),
+            end(handlers)
+        );
+    }
 }
-
@@ -0,0 +1,48 @@
+#include <tetra/FrameBudget.hpp>
+#include <tetra/TicTocClock.hpp>
+
+using namespace std;
+using namespace tetra;
+
+void
+FrameBudget::post(Job job)
+{
+    jobs.push_back(move(job));
+}
+
+int
+FrameBudget::run(double seconds)
+{
+    auto timer = HighResTicToc{};
+    auto finished = 0;
+
+    // each job gets at most one turn per run, so waiting jobs can't spin
+    auto turns = jobs.size();
+    while (turns > 0 && !jobs.empty())
+    {
+        auto job = move(jobs.front());
+        jobs.pop_front();
+        turns -= 1;
+
+        if (job())
+        {
+            finished += 1;
+        }
+        else
+        {
+            jobs.push_back(move(job));
+        }
+
+        if (timer.toc() >= seconds)
+        {
+            break;
+        }
+    }
+    return finished;
+}
+
+int
+FrameBudget::pending() const
+{
+    return jobs.size();
+}
@@ -0,0 +1,114 @@
+#include <tetra/ProximityGrid.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+using namespace tetra;
+
+namespace
+{
+    /** Keep the grid around this many cells per point however small the cutoff */
+    constexpr int CELLS_PER_POINT = 2;
+
+    /**
+     * Truncate a distance measured in cells to a cell index in [0, last].
+     * NaN and anything out of range, e.g. from infinite positions, are clamped
+     * rather than converted, which would be undefined.
+     */
+    int cellIndex(double cells, int last)
+    {
+        if (!(cells >= 0.0))
+        {
+            return 0;
+        }
+        return cells < last ? (int)cells : last;
+    }
+}
+
+void
+ProximityGrid::build(const vector<Position>& points, float cutoff)
+{
+    positions = points;
+    bin(cutoff);
+}
+
+int
+ProximityGrid::size() const
+{
+    return positions.size();
+}
+
+void
+ProximityGrid::bin(float cutoff)
+{
+    const int count = positions.size();
+    cutoffSquared = cutoff > 0.0f ? cutoff*cutoff : 0.0f;
+
+    auto low = Position{0.0f, 0.0f};
+    auto high = Position{0.0f, 0.0f};
+    if (count > 0)
+    {
+        low = high = positions.front();
+    }
+    for (const auto& position : positions)
+    {
+        for (int axis = 0; axis < 2; axis++)
+        {
+            low[axis] = min(low[axis], position[axis]);
+            high[axis] = max(high[axis], position[axis]);
+        }
+    }
+
+    // cells must be at least cutoff wide for the neighbour search to be exact,
+    // and are widened if a tiny cutoff would make the grid mostly empty cells.
+    // Bounding cells per side as well as per area keeps columns*rows around
+    // CELLS_PER_POINT*count when the points are collinear and the area is zero
+    const int maxCells = CELLS_PER_POINT*max(count, 1);
+    const double width = (double)high[0] - low[0];
+    const double height = (double)high[1] - low[1];
+    const double cellSize = max({ (double)cutoff
+                                , sqrt(width*height / maxCells)
+                                , max(width, height) / maxCells
+                                });
+    if (cellSize > 0.0 && !isinf(cellSize))
+    {
+        columns = cellIndex(width / cellSize, maxCells) + 1;
+        rows = cellIndex(height / cellSize, maxCells) + 1;
+    }
+    else
+    {
+        // every point coincides or some aren't finite, one cell compares every
+        // pair and is always exact
+        columns = 1;
+        rows = 1;
+    }
+    const int cells = columns*rows;
+
+    cellOf.resize(count);
+    cellStart.assign(cells + 1, 0);
+    for (int i = 0; i < count; i++)
+    {
+        const int column = cellIndex((positions[i][0] - low[0]) / cellSize, columns - 1);
+        const int row = cellIndex((positions[i][1] - low[1]) / cellSize, rows - 1);
+        cellOf[i] = row*columns + column;
+        cellStart[cellOf[i] + 1] += 1;
+    }
+    for (int cell = 0; cell < cells; cell++)
+    {
+        cellStart[cell + 1] += cellStart[cell];
+    }
+
+    // fill each cell backwards from its end, which leaves the start of each
+    // cell one slot to the right, then shift the starts back into place
+    sorted.resize(count);
+    for (int i = count - 1; i >= 0; i--)
+    {
+        sorted[--cellStart[cellOf[i] + 1]] = i;
+    }
+    for (int cell = 0; cell < cells; cell++)
+    {
+        cellStart[cell] = cellStart[cell + 1];
+    }
+    cellStart[cells] = count;
+}
@@ -0,0 +1,74 @@
+#include <tetra/ThreadPool.hpp>
+
+using namespace std;
+using namespace tetra;
+
+ThreadPool::ThreadPool(int threads)
+    : stopping{false}
+{
+    for (int i = 0; i < threads; i++)
+    {
+        workers.emplace_back([this]() { work(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    stop();
+}
+
+int
+ThreadPool::stop()
+{
+    int dropped;
+    {
+        auto guard = lock_guard<mutex>{lock};
+        stopping = true;
+        dropped = tasks.size();
+        tasks.clear();
+    }
+    wake.notify_all();
+
+    for (auto& worker : workers)
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+    return dropped;
+}
+
+void
+ThreadPool::submit(Task task)
+{
+    {
+        auto guard = lock_guard<mutex>{lock};
+        if (stopping)
+        {
+            return;
+        }
+        tasks.push_back(move(task));
+    }
+    wake.notify_one();
+}
+
+void
+ThreadPool::work()
+{
+    while (true)
+    {
+        auto task = Task{};
+        {
+            auto guard = unique_lock<mutex>{lock};
+            wake.wait(guard, [this]() { return stopping || !tasks.empty(); });
+            if (stopping)
+            {
+                return;
+            }
+            task = move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
@@ -0,0 +1,83 @@
+#include <Assets.hpp>
+#include <AssetCache.hpp>
+#include <AssetRoot.h>
+#include <tetra/TicTocClock.hpp>
+
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace tetra;
+
+/**
+ * Compare reading shaders with an ifstream on every load, which is how
+ * loadShaderSrc used to work, against the memory-mapped AssetCache.
+ * Also prints the lissajous vertex shader with its includes expanded.
+ */
+
+constexpr int ROUNDS = 2000;
+
+const vector<string> SHADERS = { "identity.vert"
+                               , "identity.frag"
+                               , "lissajous.vert"
+                               , "lissajous.frag"
+                               , "lissajous.geom"
+                               };
+
+double timeStreams(size_t& bytes)
+{
+    auto timer = HighResTicToc{};
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        for (const auto& name : SHADERS)
+        {
+            ifstream file(string(ASSET_ROOT) + "/shaders/" + name);
+            auto source = ostringstream{};
+            source << file.rdbuf();
+            bytes += source.str().size();
+        }
+    }
+    return timer.toc();
+}
+
+double timeCache(AssetCache& cache, size_t& bytes)
+{
+    auto timer = HighResTicToc{};
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        for (const auto& name : SHADERS)
+        {
+            bytes += cache.shader(name).data.size();
+        }
+    }
+    return timer.toc();
+}
+
+int main()
+{
+    try
+    {
+        auto cache = AssetCache{};
+        size_t streamBytes = 0, cacheBytes = 0;
+
+        cout << ROUNDS << " rounds of " << SHADERS.size() << " shaders" << endl;
+        cout << "ifstream every load " << timeStreams(streamBytes) << " seconds" << endl;
+        cout << "AssetCache          " << timeCache(cache, cacheBytes) << " seconds, "
+             << cache.mappedFiles() << " files mapped" << endl;
+
+        auto lissajous = cache.shader("lissajous.vert");
+        cout << "\nlissajous.vert (hash " << hex << lissajous.hash << dec << ")\n"
+             << lissajous.data << endl;
+    }
+    catch (exception& ex)
+    {
+        cout << ex.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,208 @@
+#include <sdl/SDLWindow.hpp>
+#include <AssetLoader.hpp>
+#include <gl/Program.hpp>
+#include <gl/VAO.hpp>
+#include <tetra/EventStream.hpp>
+#include <tetra/FrameBudget.hpp>
+#include <tetra/TicTocClock.hpp>
+
+#include <array>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace tetra;
+
+/**
+ * Start rendering straight away while shaders load in the background.
+ * Sources are read on the AssetLoader's workers, then compiled and linked on the
+ * render thread through a FrameBudget, so no single frame pays for the load.
+ */
+
+struct Vertex
+{
+    array<float, 2> pos;
+};
+
+/** Time each frame may spend on loading work, in seconds */
+constexpr double LOADING_BUDGET = 0.002;
+
+/**
+ * This class builds a program once all of its shader sources have loaded.
+ */
+class ProgramLoader
+{
+public:
+    using ShaderFiles = vector<pair<ShaderType, string>>;
+
+    ProgramLoader(EventStream& eventStream,
+                  AssetLoader& loader,
+                  FrameBudget& budget,
+                  const ShaderFiles& files)
+        : budget{budget}
+        , files{files}
+        , onLoadedListener{eventStream.addListener(*this, &ProgramLoader::onLoaded)}
+        , onFailedListener{eventStream.addListener(*this, &ProgramLoader::onFailed)}
+    {
+        for (const auto& file : files)
+        {
+            loader.loadShader(file.second);
+        }
+    }
+
+    void onLoaded(const AssetLoaded& loaded)
+    {
+        if (!needs(loaded.path))
+        {
+            return;
+        }
+        sources[loaded.path] = loaded.data;
+        if (sources.size() == files.size())
+        {
+            budget.post([this]() { return link(); });
+        }
+    }
+
+    void onFailed(const AssetFailed& failed)
+    {
+        cout << "failed to load " << failed.path << ", " << failed.reason << endl;
+    }
+
+    /**
+     * The program, or nullptr while it is still loading.
+     */
+    Program* program()
+    {
+        return _program.get();
+    }
+
+private:
+    FrameBudget& budget;
+    const ShaderFiles files;
+    unordered_map<string, string> sources;
+    unique_ptr<PendingProgram> pending;
+    unique_ptr<Program> _program;
+    EventStream::AutoRemoveListener onLoadedListener;
+    EventStream::AutoRemoveListener onFailedListener;
+
+    bool needs(const string& path) const
+    {
+        for (const auto& file : files)
+        {
+            if ("shaders/" + file.second == path)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Submit the program the first time, then wait for the driver without
+     * blocking the frame.
+     */
+    bool link()
+    {
+        if (!pending)
+        {
+            auto linker = ProgramLinker{};
+            linker.vertexAttributes({"vertex"});
+            for (const auto& file : files)
+            {
+                linker.source(file.first, sources["shaders/" + file.second]);
+            }
+            pending.reset(new PendingProgram{linker.submit()});
+            return false;
+        }
+
+        if (!pending->ready())
+        {
+            return false;
+        }
+        _program.reset(new Program{pending->get()});
+        return true;
+    }
+};
+
+void sdlmain()
+{
+    auto eventStream = EventStream{};
+    auto sdl = SDL{eventStream};
+    auto window = SDLWindow::Builder{eventStream}
+        .title("async loading")
+        .build();
+    auto gl = window.contextBuilder()
+        .majorVersion(3)
+        .minorVersion(3)
+        .build();
+
+    auto budget = FrameBudget{};
+    auto loader = AssetLoader{eventStream};
+    auto identity = ProgramLoader{
+        eventStream, loader, budget,
+        { {ShaderType::VERTEX, "identity.vert"}
+        , {ShaderType::FRAGMENT, "identity.frag"}
+        }
+    };
+
+    auto vao = Vao{};
+    auto vertexBuffer = AttribBinder<Vertex>{vao}.attrib(&Vertex::pos).bind();
+    auto vertices = vector<Vertex>{};
+    for (int i = 0; i < 64; i++)
+    {
+        auto angle = i * 2.0f * 3.1415f / 64;
+        vertices.push_back({{0.5f*cosf(angle), 0.5f*sinf(angle)}});
+    }
+    vertexBuffer.write(vertices);
+
+    auto frameTimer = HighResTicToc{};
+    auto frames = 0;
+    while (sdl.running())
+    {
+        sdl.pushEvents();
+        eventStream.dispatch();
+        budget.run(LOADING_BUDGET);
+
+        auto frameTime = frameTimer.ticToc();
+        frames += 1;
+
+        auto frame = window.draw();
+        glClearColor(0.1, 0.1, 0.1, 1.0);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        // the scene draws whatever has finished loading
+        if (auto program = identity.program())
+        {
+            vao.bind();
+            program->use();
+            vertexBuffer.draw(Primitive::LineLoop);
+        }
+        else
+        {
+            cout << "frame " << frames << " (" << frameTime << "s) still loading, "
+                 << loader.pending() << " reads and "
+                 << budget.pending() << " GL jobs pending" << endl;
+        }
+    }
+}
+
+int main()
+{
+    try
+    {
+        sdlmain();
+    }
+    catch (exception& ex)
+    {
+        cout << ex.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
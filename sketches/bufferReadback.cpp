@@ -0,0 +1,97 @@
+#include <sdl/SDLWindow.hpp>
+#include <gl/Buffer.hpp>
+#include <tetra/EventStream.hpp>
+
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace tetra;
+
+/**
+ * Check each of the Buffer readback paths against known contents.
+ *
+ * To run headless on Mesa's software rasterizer run something like:
+ *   LIBGL_ALWAYS_SOFTWARE=1 xvfb-run ./bufferReadback
+ */
+
+int failures = 0;
+
+void check(const string& name, const vector<float>& actual, const vector<float>& expected)
+{
+    bool passed = actual == expected;
+    cout << (passed ? "PASS " : "FAIL ") << name << endl;
+    failures += passed ? 0 : 1;
+}
+
+void sdlmain()
+{
+    auto eventStream = EventStream{};
+    auto sdl = SDL{eventStream};
+    auto window = SDLWindow::Builder{eventStream}
+        .title("buffer readback")
+        .build();
+    auto gl = window.contextBuilder()
+        .majorVersion(4)
+        .minorVersion(5)
+        .build();
+
+    auto contents = vector<float>{};
+    for (int i = 0; i < 1000; i++)
+    {
+        contents.push_back(i*0.5f);
+    }
+
+    auto buffer = Buffer<float>{BindTarget::Array};
+    buffer.write(contents);
+
+    check("read into new vector", buffer.read(1000), contents);
+
+    auto slice = vector<float>(begin(contents) + 100, begin(contents) + 200);
+    check("read with offset", buffer.read(100, 100), slice);
+
+    auto reused = vector<float>{};
+    buffer.read(reused, 1000);
+    check("read into reused vector", reused, contents);
+
+    auto raw = vector<float>(100);
+    buffer.read(raw.data(), 100, 100);
+    check("read into raw storage", raw, slice);
+
+    auto pending = buffer.readAsync(100, 100);
+    auto async = vector<float>{};
+    pending.get(async);
+    check("async read", async, slice);
+
+    contents[500] = -1.0f;
+    buffer.update(500, &contents[500], 1);
+    auto polled = buffer.readAsync(1000);
+    while (!polled.ready()) { }
+    polled.get(reused);
+    check("async read after update", reused, contents);
+
+    auto staging = Buffer<float>{BindTarget::CopyWrite};
+    for (int offset : {0, 100, 200})
+    {
+        buffer.readAsync(staging, 100, offset).get(async);
+        auto expected = vector<float>(begin(contents) + offset, begin(contents) + offset + 100);
+        check("async read into reused staging at " + to_string(offset), async, expected);
+    }
+}
+
+int main()
+{
+    try
+    {
+        sdlmain();
+    }
+    catch (exception& ex)
+    {
+        cout << ex.what() << endl;
+        return 1;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+#include <sdl/SDLWindow.hpp>
+#include <Assets.hpp>
+#include <gl/Program.hpp>
+#include <gl/VAO.hpp>
+#include <gl/VertexLayout.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+
+using namespace std;
+using namespace tetra;
+using namespace tetra::vertex;
+
+/**
+ * Draw a color wheel from compact vertices: half float positions and 8 bit
+ * normalized colors, a third of the size of the equivalent float vertex.
+ */
+
+struct FloatVertex
+{
+    array<float, 2> pos;
+    array<float, 4> color;
+};
+
+struct CompactVertex
+{
+    array<Half, 2> pos;
+    array<Norm<uint8_t>, 4> color;
+};
+
+constexpr auto compactLayout = array<VertexAttrib, 2>{
+    VERTEX_ATTRIB(CompactVertex, pos),
+    VERTEX_ATTRIB(CompactVertex, color)
+};
+static_assert(validLayout<CompactVertex>(compactLayout),
+              "CompactVertex attributes overlap");
+
+constexpr int SEGMENTS = 64;
+
+CompactVertex compact(float x, float y, float r, float g, float b)
+{
+    return { {toHalf(x), toHalf(y)}
+           , { normalized<uint8_t>(r)
+             , normalized<uint8_t>(g)
+             , normalized<uint8_t>(b)
+             , normalized<uint8_t>(1.0f)
+             }
+           };
+}
+
+vector<CompactVertex> colorWheel()
+{
+    auto vertices = vector<CompactVertex>{compact(0, 0, 1, 1, 1)};
+    for (int i = 0; i <= SEGMENTS; i++)
+    {
+        auto angle = i * 2.0f * 3.1415f / SEGMENTS;
+        vertices.push_back(compact(
+            0.8f*cosf(angle), 0.8f*sinf(angle),
+            0.5f + 0.5f*cosf(angle),
+            0.5f + 0.5f*cosf(angle - 2.094f),
+            0.5f + 0.5f*cosf(angle + 2.094f)
+        ));
+    }
+    return vertices;
+}
+
+void sdlmain()
+{
+    auto eventStream = EventStream{};
+    auto sdl = SDL{eventStream};
+    auto window = SDLWindow::Builder{eventStream}
+        .title("compact vertices")
+        .build();
+    auto gl = window.contextBuilder()
+        .majorVersion(3)
+        .minorVersion(3)
+        .build();
+
+    auto program = ProgramLinker{}
+        .vertexAttributes({"vertex", "color"})
+        .source(ShaderType::VERTEX, loadShaderSrc("vertexColor.vert"))
+        .source(ShaderType::FRAGMENT, loadShaderSrc("vertexColor.frag"))
+        .link();
+
+    auto vao = Vao{};
+    auto buffer = AttribBinder<CompactVertex>{vao}.layout(compactLayout).bind();
+    buffer.write(colorWheel());
+
+    cout << "float vertex " << sizeof(FloatVertex) << " bytes, "
+         << "compact vertex " << sizeof(CompactVertex) << " bytes" << endl;
+
+    while (sdl.running())
+    {
+        sdl.pushEvents();
+        eventStream.dispatch();
+
+        auto frame = window.draw();
+        glClearColor(0.0, 0.0, 0.0, 0.0);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        vao.bind();
+        program.use();
+        buffer.draw(Primitive::TriangleFan);
+    }
+}
+
+int main()
+{
+    try
+    {
+        sdlmain();
+    }
+    catch (exception& ex)
+    {
+        cout << ex.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
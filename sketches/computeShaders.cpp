@@ -0,0 +1,204 @@
+#include <sdl/SDLWindow.hpp>
+#include <Assets.hpp>
+#include <gl/Compute.hpp>
+#include <gl/Program.hpp>
+#include <gl/VAO.hpp>
+#include <tetra/EventStream.hpp>
+
+#include <array>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace tetra;
+
+/**
+ * Run the lissajous vertices and a particle update as compute shaders, then
+ * check the GPU's results against the same math on the CPU.
+ *
+ * Mesa's llvmpipe supports GL 4.5 compute, so to run headless try:
+ *   LIBGL_ALWAYS_SOFTWARE=1 xvfb-run ./computeShaders
+ */
+
+using Vec2 = array<float, 2>;
+
+struct Particle
+{
+    Vec2 pos;
+    Vec2 vel;
+};
+
+constexpr int VERTICES = 1000;
+constexpr int PARTICLES = 10000;
+constexpr int STEPS = 60;
+constexpr float DT = 1.0f/60;
+
+int failures = 0;
+
+void check(const string& name, bool passed)
+{
+    cout << (passed ? "PASS " : "FAIL ") << name << endl;
+    failures += passed ? 0 : 1;
+}
+
+bool near(const Vec2& a, const Vec2& b)
+{
+    return fabs(a[0] - b[0]) < 1e-3f && fabs(a[1] - b[1]) < 1e-3f;
+}
+
+vector<Vec2> lissajous(int count, float time)
+{
+    auto vertices = vector<Vec2>{};
+    for (int i = 0; i < count; i++)
+    {
+        auto angle = (float)i/count * 2.0f*3.1415f;
+        vertices.push_back({ 0.9f*sinf(1.5f*angle + time)*cosf(angle)
+                           , 0.9f*cosf(angle + time)*cosf(angle)
+                           });
+    }
+    return vertices;
+}
+
+bool matches(const vector<Vec2>& actual, const vector<Vec2>& expected)
+{
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        if (!near(actual[i], expected[i]))
+        {
+            return false;
+        }
+    }
+    return actual.size() == expected.size();
+}
+
+void step(vector<Particle>& particles)
+{
+    for (auto& particle : particles)
+    {
+        for (int axis = 0; axis < 2; axis++)
+        {
+            particle.pos[axis] += particle.vel[axis]*DT;
+            if (fabs(particle.pos[axis]) > 1.0f)
+            {
+                particle.vel[axis] = -particle.vel[axis];
+            }
+        }
+    }
+}
+
+Program computeProgram(const string& file)
+{
+    return ProgramLinker{}
+        .source(ShaderType::COMPUTE, loadShaderSrc(file))
+        .link();
+}
+
+void checkLissajous()
+{
+    auto program = computeProgram("lissajous.comp");
+    check("work group size", workGroupSize(program) == array<GLint, 3>{64, 1, 1});
+
+    auto vertices = Buffer<Vec2>{BindTarget::ShaderStorage};
+    vertices.reserve(VERTICES, UsageHint::DynamicCopy);
+    vertices.bindStorage(0);
+
+    program.use();
+    program.uniform(program.uniformLocation("time"), 0.5f);
+    program.uniform(program.uniformLocation("count"), (unsigned int)VERTICES);
+    dispatch(program, groupsFor(VERTICES, 64));
+    memoryBarrier(BufferUpdateBarrier);
+    check("dispatch", matches(vertices.read(VERTICES), lissajous(VERTICES, 0.5f)));
+
+    auto commands = Buffer<DispatchIndirectCommand>{BindTarget::DispatchIndirect};
+    commands.write({{groupsFor(VERTICES, 64), 1, 1}});
+    program.uniform(program.uniformLocation("time"), 2.0f);
+    dispatchIndirect(program, commands);
+    memoryBarrier(BufferUpdateBarrier);
+    check("dispatch indirect", matches(vertices.read(VERTICES), lissajous(VERTICES, 2.0f)));
+}
+
+void checkParticles(SDLWindow& window)
+{
+    auto update = computeProgram("particles.comp");
+    auto draw = ProgramLinker{}
+        .vertexAttributes({"vertex"})
+        .source(ShaderType::VERTEX, loadShaderSrc("identity.vert"))
+        .source(ShaderType::FRAGMENT, loadShaderSrc("identity.frag"))
+        .link();
+
+    auto expected = vector<Particle>{};
+    for (int i = 0; i < PARTICLES; i++)
+    {
+        auto angle = i*0.618f;
+        auto r = (float)i/PARTICLES;
+        expected.push_back({{r*cosf(angle), r*sinf(angle)}, {sinf(3*angle), cosf(5*angle)}});
+    }
+
+    // the same buffer is written by the compute shader and drawn as points
+    auto vao = Vao{};
+    auto particles = AttribBinder<Particle>{vao}.attrib(&Particle::pos).bind();
+    particles.write(expected, UsageHint::DynamicCopy);
+    particles.bindStorage(0);
+
+    update.use();
+    update.uniform(update.uniformLocation("dt"), DT);
+    update.uniform(update.uniformLocation("count"), (unsigned int)PARTICLES);
+    const auto groups = groupsFor(PARTICLES, workGroupSize(update)[0]);
+
+    for (int i = 0; i < STEPS; i++)
+    {
+        dispatch(update, groups);
+        memoryBarrier(VertexAttribArrayBarrier | ShaderStorageBarrier);
+        step(expected);
+
+        auto frame = window.draw();
+        glClear(GL_COLOR_BUFFER_BIT);
+        vao.bind();
+        draw.use();
+        particles.draw(Primitive::Points);
+    }
+
+    memoryBarrier(BufferUpdateBarrier);
+    auto actual = particles.read(PARTICLES);
+    bool passed = true;
+    for (int i = 0; i < PARTICLES; i++)
+    {
+        passed = passed && near(actual[i].pos, expected[i].pos)
+                        && near(actual[i].vel, expected[i].vel);
+    }
+    check("particle update", passed);
+}
+
+void sdlmain()
+{
+    auto eventStream = EventStream{};
+    auto sdl = SDL{eventStream};
+    auto window = SDLWindow::Builder{eventStream}
+        .title("compute shaders")
+        .build();
+    auto gl = window.contextBuilder()
+        .majorVersion(4)
+        .minorVersion(5)
+        .build();
+
+    checkLissajous();
+    checkParticles(window);
+}
+
+int main()
+{
+    try
+    {
+        sdlmain();
+    }
+    catch (exception& ex)
+    {
+        cout << ex.what() << endl;
+        return 1;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,69 @@
+#include <gl/Buffer.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace tetra;
+
+/**
+ * Check how DirtyRanges merges overlapping, adjacent and disjoint ranges.
+ * This is CPU only, no GL context is created.
+ */
+
+int failures = 0;
+
+void check(const string& name,
+           const DirtyRanges& dirty,
+           const vector<DirtyRanges::Range>& expected)
+{
+    const auto& actual = dirty.ranges();
+    bool passed = actual.size() == expected.size();
+    for (size_t i = 0; passed && i < expected.size(); i++)
+    {
+        passed = actual[i].first == expected[i].first
+              && actual[i].last == expected[i].last;
+    }
+
+    cout << (passed ? "PASS " : "FAIL ") << name << endl;
+    if (!passed)
+    {
+        for (const auto& range : actual)
+        {
+            cout << "    [" << range.first << ", " << range.last << ")" << endl;
+        }
+    }
+    failures += passed ? 0 : 1;
+}
+
+int main()
+{
+    auto dirty = DirtyRanges{};
+    check("starts empty", dirty, {});
+
+    dirty.mark(10, 5);
+    dirty.mark(0, 3);
+    check("disjoint ranges stay separate and sorted", dirty, {{0, 3}, {10, 15}});
+
+    dirty.mark(3, 2);
+    check("adjacent range on the left merges", dirty, {{0, 5}, {10, 15}});
+
+    dirty.mark(15);
+    check("adjacent element on the right merges", dirty, {{0, 5}, {10, 16}});
+
+    dirty.mark(1, 2);
+    check("contained range changes nothing", dirty, {{0, 5}, {10, 16}});
+
+    dirty.mark(20, 2);
+    dirty.mark(30, 2);
+    dirty.mark(4, 27);
+    check("overlapping range swallows several", dirty, {{0, 32}});
+
+    dirty.clear();
+    check("clear forgets everything", dirty, {});
+    cout << (dirty.empty() ? "PASS " : "FAIL ") << "empty after clear" << endl;
+    failures += dirty.empty() ? 0 : 1;
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,175 @@
+#include <tetra/EventStream.hpp>
+
+#include <sdl/SDLEvents.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace tetra;
+
+/**
+ * Check each of the EventStream coalescing modes, including that merged events
+ * are dispatched at the position of the event they were merged into.
+ */
+
+/**
+ * An event with an operator== so it can be used with dropDuplicates.
+ */
+struct Key
+{
+    int code;
+};
+
+bool operator==(const Key& a, const Key& b)
+{
+    return a.code == b.code;
+}
+
+/**
+ * An event which is never coalesced, used to show ordering.
+ */
+struct Marker
+{
+    int value;
+};
+
+/**
+ * Log every dispatched event as a short string so whole sequences can be
+ * compared at once.
+ */
+class Recorder
+{
+public:
+    Recorder(EventStream& eventStream)
+        : mouse{eventStream.addListener(*this, &Recorder::onMouse)}
+        , size{eventStream.addListener(*this, &Recorder::onSize)}
+        , key{eventStream.addListener(*this, &Recorder::onKey)}
+        , marker{eventStream.addListener(*this, &Recorder::onMarker)}
+    { }
+
+    void onMouse(const SDLMousePosition& p)
+    {
+        log.push_back("mouse " + to_string(p.x) + " " + to_string(p.relx));
+    }
+
+    void onSize(const SDLWindowSize& s)
+    {
+        log.push_back("size " + to_string(s.width));
+    }
+
+    void onKey(const Key& k)
+    {
+        log.push_back("key " + to_string(k.code));
+    }
+
+    void onMarker(const Marker& m)
+    {
+        log.push_back("marker " + to_string(m.value));
+    }
+
+    vector<string> log;
+private:
+    EventStream::AutoRemoveListener mouse;
+    EventStream::AutoRemoveListener size;
+    EventStream::AutoRemoveListener key;
+    EventStream::AutoRemoveListener marker;
+};
+
+int failures = 0;
+
+void check(const string& name, const vector<string>& actual, const vector<string>& expected)
+{
+    bool passed = actual == expected;
+    cout << (passed ? "PASS " : "FAIL ") << name << endl;
+    if (!passed)
+    {
+        for (const auto& line : actual)
+        {
+            cout << "    " << line << endl;
+        }
+    }
+    failures += passed ? 0 : 1;
+}
+
+void checkCoalesce()
+{
+    auto eventStream = EventStream{};
+    auto recorder = Recorder{eventStream};
+    eventStream.coalesce<SDLMousePosition>(accumulateMotion);
+
+    eventStream.push(SDLMousePosition{1, 1, 1, 1});
+    eventStream.push(Marker{1});
+    eventStream.push(SDLMousePosition{2, 2, 3, 3});
+    eventStream.dispatch();
+
+    // the merged motion stays ahead of the marker pushed between the two moves
+    check("coalesce merges at the pending position",
+          recorder.log, {"mouse 2 4", "marker 1"});
+}
+
+void checkKeepLatest()
+{
+    auto eventStream = EventStream{};
+    auto recorder = Recorder{eventStream};
+    eventStream.keepLatest<SDLWindowSize>();
+
+    eventStream.push(SDLWindowSize{800, 600});
+    eventStream.push(SDLWindowSize{1024, 768});
+    eventStream.push(SDLWindowSize{640, 480});
+    eventStream.dispatch();
+    eventStream.push(SDLWindowSize{320, 240});
+    eventStream.dispatch();
+
+    check("keepLatest keeps one pending event",
+          recorder.log, {"size 640", "size 320"});
+}
+
+void checkDropDuplicates()
+{
+    auto eventStream = EventStream{};
+    auto recorder = Recorder{eventStream};
+    eventStream.dropDuplicates<Key>();
+
+    for (int code : {1, 1, 2, 2, 2, 1})
+    {
+        eventStream.push(Key{code});
+    }
+    eventStream.dispatch();
+
+    check("dropDuplicates only drops repeats of the pending event",
+          recorder.log, {"key 1", "key 2", "key 1"});
+}
+
+void checkPartialDispatch()
+{
+    // one event per dispatch leaves events queued between dispatches
+    auto eventStream = EventStream{1};
+    auto recorder = Recorder{eventStream};
+    eventStream.keepLatest<SDLWindowSize>();
+
+    eventStream.push(SDLWindowSize{1, 1});
+    eventStream.push(Marker{1});
+    eventStream.dispatch();
+
+    // the first size was dispatched, so this starts a new pending event
+    eventStream.push(SDLWindowSize{2, 2});
+    eventStream.push(SDLWindowSize{3, 3});
+    eventStream.dispatch();
+    eventStream.dispatch();
+    eventStream.dispatch();
+
+    check("no merging into dispatched events",
+          recorder.log, {"size 1", "marker 1", "size 3"});
+}
+
+int main()
+{
+    checkCoalesce();
+    checkKeepLatest();
+    checkDropDuplicates();
+    checkPartialDispatch();
+
+    return failures == 0 ? 0 : 1;
+}
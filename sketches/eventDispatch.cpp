@@ -0,0 +1,222 @@
+#include <tetra/EventStream.hpp>
+#include <tetra/TicTocClock.hpp>
+
+#include <sdl/SDLEvents.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <vector>
+
+using namespace std;
+using namespace tetra;
+
+/**
+ * Count every heap allocation made by the program so steady-state frames can be
+ * checked for allocations.
+ */
+static long allocations = 0;
+
+void* operator new(size_t size)
+{
+    allocations += 1;
+    if (void* ptr = malloc(size))
+    {
+        return ptr;
+    }
+    throw bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+/**
+ * The event which is pushed through the stream on every iteration.
+ */
+struct Ping { int value; };
+
+/**
+ * An event type which is never pushed, used to fill up the stream with
+ * listeners that should never be called.
+ */
+struct Unrelated { int value; };
+
+class PingCounter
+{
+public:
+    PingCounter(EventStream& eventStream)
+        : listener{eventStream.addListener(*this, &PingCounter::onPing)}
+    { }
+
+    void onPing(const Ping& ping)
+    {
+        total += ping.value;
+    }
+
+    long total = 0;
+private:
+    EventStream::AutoRemoveListener listener;
+};
+
+class UnrelatedCounter
+{
+public:
+    UnrelatedCounter(EventStream& eventStream)
+        : listener{eventStream.addListener(*this, &UnrelatedCounter::onUnrelated)}
+    { }
+
+    void onUnrelated(const Unrelated& unrelated)
+    {
+        total += unrelated.value;
+    }
+
+    long total = 0;
+private:
+    EventStream::AutoRemoveListener listener;
+};
+
+/**
+ * Time how long it takes to dispatch a fixed number of Ping events with a
+ * given number of matching and non-matching listeners.
+ */
+double timeDispatch(int matching, int unrelated, int events)
+{
+    auto eventStream = EventStream{events};
+
+    auto pingCounters = vector<unique_ptr<PingCounter>>{};
+    for (int i = 0; i < matching; i++)
+    {
+        pingCounters.emplace_back(new PingCounter{eventStream});
+    }
+
+    auto unrelatedCounters = vector<unique_ptr<UnrelatedCounter>>{};
+    for (int i = 0; i < unrelated; i++)
+    {
+        unrelatedCounters.emplace_back(new UnrelatedCounter{eventStream});
+    }
+
+    for (int i = 0; i < events; i++)
+    {
+        eventStream.push(Ping{1});
+    }
+
+    auto timer = HighResTicToc{};
+    eventStream.dispatch();
+    return timer.toc();
+}
+
+/**
+ * Time how long it takes to drain a burst of events through a single listener.
+ */
+double timeDrain(int events)
+{
+    auto eventStream = EventStream{events};
+    auto counter = PingCounter{eventStream};
+
+    for (int i = 0; i < events; i++)
+    {
+        eventStream.push(Ping{1});
+    }
+
+    auto timer = HighResTicToc{};
+    eventStream.dispatch();
+    return timer.toc();
+}
+
+class InputListener
+{
+public:
+    InputListener(EventStream& eventStream)
+        : mouseMove{eventStream.addListener(*this, &InputListener::onMouseMove)}
+        , resize{eventStream.addListener(*this, &InputListener::onResize)}
+    { }
+
+    void onMouseMove(const SDLMousePosition& position) { x = position.x; }
+    void onResize(const SDLWindowSize& size) { width = size.width; }
+
+    int x = 0;
+    int width = 0;
+private:
+    EventStream::AutoRemoveListener mouseMove;
+    EventStream::AutoRemoveListener resize;
+};
+
+/**
+ * Count the heap allocations made while pushing and dispatching a frame's worth
+ * of input events, after the stream has warmed up.
+ */
+long allocationsPerFrame(int frames)
+{
+    auto eventStream = EventStream{};
+    auto listener = InputListener{eventStream};
+
+    auto frame = [&]() {
+        for (int i = 0; i < 50; i++)
+        {
+            eventStream.push(SDLMousePosition{i, i, 1, 1});
+        }
+        eventStream.push(SDLWindowSize{800, 600});
+        eventStream.dispatch();
+    };
+
+    // the first frame grows the queue to its working size
+    frame();
+
+    auto before = allocations;
+    for (int i = 0; i < frames; i++)
+    {
+        frame();
+    }
+    return allocations - before;
+}
+
+int main()
+{
+    constexpr int events = 10000;
+
+    cout << "dispatching " << events << " events" << endl;
+    cout << "matching\tunrelated\tseconds" << endl;
+    for (int matching : {1, 10})
+    {
+        for (int unrelated : {0, 10, 100, 1000})
+        {
+            cout << matching << "\t\t" << unrelated << "\t\t"
+                 << timeDispatch(matching, unrelated, events) << endl;
+        }
+    }
+
+    /*
+     * Listeners are bucketed by event type, so the dispatch time should stay
+     * roughly flat as the number of unrelated listeners grows and only scale
+     * with the number of matching listeners.
+     */
+
+    cout << endl << "events\t\tseconds" << endl;
+    for (int burst : {1000, 10000, 100000})
+    {
+        cout << burst << "\t\t" << timeDrain(burst) << endl;
+    }
+
+    /*
+     * Events are dequeued from a ring buffer, so draining a burst should scale
+     * linearly with the number of events in it.
+     */
+
+    auto steadyStateAllocations = allocationsPerFrame(1000);
+    cout << endl << "heap allocations over 1000 steady-state frames: "
+         << steadyStateAllocations << endl;
+
+    /*
+     * SDL events are small and trivially copyable, so they are stored inline in
+     * the queue and the count above should be zero.
+     */
+    return steadyStateAllocations == 0 ? 0 : 1;
+}
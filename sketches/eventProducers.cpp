@@ -0,0 +1,92 @@
+#include <tetra/EventStream.hpp>
+#include <tetra/TicTocClock.hpp>
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace tetra;
+
+/**
+ * The event pushed by each background producer.
+ * Sequence numbers let the consumer check that each producer's events arrive
+ * in the order they were pushed.
+ */
+struct Work
+{
+    int producer;
+    int sequence;
+};
+
+class WorkCounter
+{
+public:
+    WorkCounter(EventStream& eventStream, int producers)
+        : nextSequence(producers, 0)
+        , listener{eventStream.addListener(*this, &WorkCounter::onWork)}
+    { }
+
+    void onWork(const Work& work)
+    {
+        if (work.sequence != nextSequence[work.producer])
+        {
+            outOfOrder += 1;
+        }
+        nextSequence[work.producer] = work.sequence + 1;
+        received += 1;
+    }
+
+    vector<int> nextSequence;
+    long received = 0;
+    long outOfOrder = 0;
+private:
+    EventStream::AutoRemoveListener listener;
+};
+
+/**
+ * Hammer the event stream from several producer threads while the main thread
+ * dispatches.
+ * Build with -fsanitize=thread to have ThreadSanitizer check the stream.
+ */
+int main()
+{
+    constexpr int producers = 8;
+    constexpr int eventsPerProducer = 100000;
+    constexpr long total = (long)producers * eventsPerProducer;
+
+    auto eventStream = EventStream{1000};
+    auto counter = WorkCounter{eventStream, producers};
+    auto timer = HighResTicToc{};
+
+    auto go = atomic<bool>{false};
+    auto threads = vector<thread>{};
+    for (int producer = 0; producer < producers; producer++)
+    {
+        threads.emplace_back([&, producer]() {
+            while (!go.load()) { }
+            for (int sequence = 0; sequence < eventsPerProducer; sequence++)
+            {
+                eventStream.push(Work{producer, sequence});
+            }
+        });
+    }
+
+    go.store(true);
+    while (counter.received < total)
+    {
+        eventStream.dispatch();
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    cout << "received " << counter.received << " of " << total << " events from "
+         << producers << " producers in " << timer.toc() << " seconds" << endl;
+    cout << "out of order: " << counter.outOfOrder << endl;
+
+    return counter.outOfOrder == 0 ? 0 : 1;
+}
@@ -0,0 +1,137 @@
+#include <sdl/SDLWindow.hpp>
+#include <Assets.hpp>
+#include <gl/Program.hpp>
+#include <gl/FeedbackLoop.hpp>
+#include <gl/VertexLayout.hpp>
+#include <tetra/EventStream.hpp>
+#include <tetra/TicTocClock.hpp>
+
+#include <array>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace tetra;
+
+/**
+ * Keep particles on the GL and move them with transform feedback on a GL 3.3
+ * context, then check the result against the same update on the CPU.
+ *
+ * To run headless on Mesa's software rasterizer run something like:
+ *   LIBGL_ALWAYS_SOFTWARE=1 xvfb-run ./feedbackParticles
+ */
+
+struct Particle
+{
+    array<float, 2> pos;
+    array<float, 2> vel;
+};
+
+constexpr auto particleLayout = array<VertexAttrib, 2>{
+    VERTEX_ATTRIB(Particle, pos), VERTEX_ATTRIB(Particle, vel)
+};
+static_assert(validLayout<Particle>(particleLayout), "overlapping attributes");
+
+constexpr int PARTICLES = 10000;
+constexpr int STEPS = 60;
+constexpr float DT = 1.0f/60;
+
+void step(vector<Particle>& particles)
+{
+    for (auto& particle : particles)
+    {
+        for (int axis = 0; axis < 2; axis++)
+        {
+            particle.pos[axis] += particle.vel[axis]*DT;
+            if (fabs(particle.pos[axis]) > 1.0f)
+            {
+                particle.vel[axis] = -particle.vel[axis];
+            }
+        }
+    }
+}
+
+bool near(const array<float, 2>& a, const array<float, 2>& b)
+{
+    return fabs(a[0] - b[0]) < 1e-3f && fabs(a[1] - b[1]) < 1e-3f;
+}
+
+bool sdlmain()
+{
+    auto eventStream = EventStream{};
+    auto sdl = SDL{eventStream};
+    auto window = SDLWindow::Builder{eventStream}
+        .title("transform feedback particles")
+        .build();
+    auto gl = window.contextBuilder()
+        .majorVersion(3)
+        .minorVersion(3)
+        .build();
+
+    auto update = ProgramLinker{}
+        .vertexAttributes({"pos", "vel"})
+        .feedbackVaryings({"outPos", "outVel"})
+        .source(ShaderType::VERTEX, loadShaderSrc("particles.vert"))
+        .link();
+    auto draw = ProgramLinker{}
+        .vertexAttributes({"vertex"})
+        .source(ShaderType::VERTEX, loadShaderSrc("identity.vert"))
+        .source(ShaderType::FRAGMENT, loadShaderSrc("identity.frag"))
+        .link();
+
+    auto expected = vector<Particle>{};
+    for (int i = 0; i < PARTICLES; i++)
+    {
+        auto angle = i*0.618f;
+        auto r = (float)i/PARTICLES;
+        expected.push_back({{r*cosf(angle), r*sinf(angle)}, {sinf(3*angle), cosf(5*angle)}});
+    }
+
+    auto particles = FeedbackLoop<Particle>{particleLayout};
+    particles.write(expected);
+
+    update.use();
+    update.uniform(update.uniformLocation("dt"), DT);
+
+    auto timer = HighResTicToc{};
+    for (int i = 0; i < STEPS; i++)
+    {
+        particles.step(update);
+        step(expected);
+
+        auto frame = window.draw();
+        glClear(GL_COLOR_BUFFER_BIT);
+        draw.use();
+        particles.draw(Primitive::Points);
+    }
+    glFinish();
+    cout << STEPS << " steps of " << PARTICLES << " particles in "
+         << timer.toc() << " seconds" << endl;
+
+    auto actual = particles.read();
+    for (int i = 0; i < PARTICLES; i++)
+    {
+        if (!near(actual[i].pos, expected[i].pos) || !near(actual[i].vel, expected[i].vel))
+        {
+            cout << "FAIL particle " << i << " differs from the CPU update" << endl;
+            return false;
+        }
+    }
+    cout << "PASS transform feedback matches the CPU update" << endl;
+    return true;
+}
+
+int main()
+{
+    try
+    {
+        return sdlmain() ? 0 : 1;
+    }
+    catch (exception& ex)
+    {
+        cout << ex.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,154 @@
+#include <sdl/SDLWindow.hpp>
+#include <Assets.hpp>
+#include <gl/IndirectBatch.hpp>
+#include <gl/Program.hpp>
+#include <gl/VAO.hpp>
+#include <tetra/TicTocClock.hpp>
+
+#include <array>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace tetra;
+
+/**
+ * Compare drawing thousands of small shapes with one glDrawElementsBaseVertex
+ * each against one glMultiDrawElementsIndirect for all of them.
+ * Both draw from the same packed buffers, so the difference is per-draw CPU
+ * overhead.
+ *
+ * To benchmark headless on Mesa's software rasterizer run something like:
+ *   LIBGL_ALWAYS_SOFTWARE=1 xvfb-run ./indirectBatch
+ */
+
+struct Vertex
+{
+    array<float, 2> pos;
+};
+
+constexpr int COLUMNS = 80;
+constexpr int ROWS = 60;
+constexpr int FRAMES = 200;
+
+/**
+ * A regular polygon as a triangle fan of indices around its center.
+ */
+void polygon(float x, float y, float radius, int sides,
+             vector<Vertex>& vertices, vector<GLuint>& indices)
+{
+    vertices = {Vertex{{x, y}}};
+    indices.clear();
+    for (int side = 0; side < sides; side++)
+    {
+        auto angle = side * 2.0f * 3.1415f / sides;
+        vertices.push_back(Vertex{{x + radius*cosf(angle), y + radius*sinf(angle)}});
+        indices.insert(end(indices), {0u, (GLuint)side + 1, (GLuint)(side + 1) % sides + 1});
+    }
+}
+
+double benchSeparate(SDLWindow& window, Program& program, Vao& vao,
+                     const vector<BatchedMesh>& meshes)
+{
+    auto timer = HighResTicToc{};
+    for (int frame = 0; frame < FRAMES; frame++)
+    {
+        auto drawFrame = window.draw();
+        glClear(GL_COLOR_BUFFER_BIT);
+        vao.bind();
+        program.use();
+        for (const auto& mesh : meshes)
+        {
+            glDrawElementsBaseVertex(
+                GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT,
+                (const GLvoid*)(sizeof(GLuint) * mesh.firstIndex), mesh.firstVertex
+            );
+        }
+    }
+    glFinish();
+    return timer.toc();
+}
+
+double benchBatched(SDLWindow& window, Program& program,
+                    IndirectBatch<Vertex, GLuint>& batch,
+                    const vector<BatchedMesh>& meshes)
+{
+    auto timer = HighResTicToc{};
+    for (int frame = 0; frame < FRAMES; frame++)
+    {
+        auto drawFrame = window.draw();
+        glClear(GL_COLOR_BUFFER_BIT);
+        program.use();
+        for (const auto& mesh : meshes)
+        {
+            batch.draw(mesh);
+        }
+        batch.submit(Primitive::Triangles);
+    }
+    glFinish();
+    return timer.toc();
+}
+
+void sdlmain()
+{
+    auto eventStream = EventStream{};
+    auto sdl = SDL{eventStream};
+    auto window = SDLWindow::Builder{eventStream}
+        .title("indirect batch benchmark")
+        .build();
+    auto gl = window.contextBuilder()
+        .majorVersion(4)
+        .minorVersion(5)
+        .build();
+
+    auto program = ProgramLinker{}
+        .vertexAttributes({"vertex"})
+        .source(ShaderType::VERTEX, loadShaderSrc("identity.vert"))
+        .source(ShaderType::FRAGMENT, loadShaderSrc("identity.frag"))
+        .link();
+
+    auto vao = Vao{};
+    auto batch = IndirectBatch<Vertex, GLuint>{
+        vao, AttribBinder<Vertex>{vao}.attrib(&Vertex::pos)
+    };
+
+    auto meshes = vector<BatchedMesh>{};
+    auto vertices = vector<Vertex>{};
+    auto indices = vector<GLuint>{};
+    for (int row = 0; row < ROWS; row++)
+    {
+        for (int column = 0; column < COLUMNS; column++)
+        {
+            auto x = -1.0f + (column + 0.5f) * 2.0f / COLUMNS;
+            auto y = -1.0f + (row + 0.5f) * 2.0f / ROWS;
+            polygon(x, y, 0.4f / COLUMNS, 3 + (row + column) % 6, vertices, indices);
+            meshes.push_back(batch.add(vertices, indices));
+        }
+    }
+
+    // the first submit uploads the packed meshes for both benchmarks
+    batch.submit(Primitive::Triangles);
+
+    cout << FRAMES << " frames of " << meshes.size() << " shapes" << endl;
+    cout << "one draw per shape " << benchSeparate(window, program, vao, meshes)
+         << " seconds" << endl;
+    cout << "multi-draw indirect " << benchBatched(window, program, batch, meshes)
+         << " seconds" << endl;
+}
+
+int main()
+{
+    try
+    {
+        sdlmain();
+    }
+    catch (exception& ex)
+    {
+        cout << ex.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
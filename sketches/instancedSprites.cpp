@@ -0,0 +1,125 @@
+#include <sdl/SDLWindow.hpp>
+#include <Assets.hpp>
+#include <gl/Program.hpp>
+#include <gl/VAO.hpp>
+#include <gl/VertexLayout.hpp>
+#include <tetra/TicTocClock.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+
+using namespace std;
+using namespace tetra;
+using namespace tetra::vertex;
+
+/**
+ * Draw tens of thousands of moving sprites with a single instanced draw.
+ * Every sprite shares one quad, the offset and color come from a per-instance
+ * attribute buffer which is rewritten each frame.
+ */
+
+struct Vertex
+{
+    array<float, 2> pos;
+};
+
+struct Sprite
+{
+    array<float, 2> offset;
+    array<Norm<uint8_t>, 4> color;
+};
+
+constexpr int SPRITES = 20000;
+constexpr float SIZE = 0.004f;
+
+void moveSprites(vector<Sprite>& sprites, float time)
+{
+    for (int i = 0; i < SPRITES; i++)
+    {
+        auto r = (float)i / SPRITES;
+        auto angle = r * 200.0f + time * (0.2f + r);
+        sprites[i].offset = {0.9f*r*cosf(angle), 0.9f*r*sinf(angle)};
+        sprites[i].color = { normalized<uint8_t>(r)
+                           , normalized<uint8_t>(1.0f - r)
+                           , normalized<uint8_t>(1.0f)
+                           , normalized<uint8_t>(0.8f)
+                           };
+    }
+}
+
+void sdlmain()
+{
+    auto eventStream = EventStream{};
+    auto sdl = SDL{eventStream};
+    auto window = SDLWindow::Builder{eventStream}
+        .title("instanced sprites")
+        .build();
+    auto gl = window.contextBuilder()
+        .majorVersion(3)
+        .minorVersion(3)
+        .build();
+
+    // attribute indices: the quad's vertex, then the sprite's offset and color
+    auto program = ProgramLinker{}
+        .vertexAttributes({"vertex", "offset", "color"})
+        .source(ShaderType::VERTEX, loadShaderSrc("instanced.vert"))
+        .source(ShaderType::FRAGMENT, loadShaderSrc("vertexColor.frag"))
+        .link();
+
+    auto vao = Vao{};
+    auto quad = AttribBinder<Vertex>{vao}
+        .attrib(&Vertex::pos)
+        .bind();
+    quad.write({ Vertex{{-SIZE, -SIZE}}
+               , Vertex{{ SIZE, -SIZE}}
+               , Vertex{{-SIZE,  SIZE}}
+               , Vertex{{ SIZE,  SIZE}}
+               });
+
+    auto instances = AttribBinder<Sprite>{vao}
+        .firstIndex(1)
+        .divisor(1)
+        .attrib(&Sprite::offset)
+        .attrib(&Sprite::color)
+        .bind();
+
+    auto sprites = vector<Sprite>(SPRITES);
+    auto frameTimer = HighResTicToc{};
+    auto totalTime = HighResTicToc{};
+    while (sdl.running())
+    {
+        sdl.pushEvents();
+        eventStream.dispatch();
+
+        cout << "frame time: " << frameTimer.ticToc() << " for " << SPRITES
+             << " sprites in 1 draw" << endl;
+        moveSprites(sprites, totalTime.toc());
+        instances.write(sprites);
+
+        auto frame = window.draw();
+        glClearColor(0.0, 0.0, 0.0, 0.0);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        vao.bind();
+        program.use();
+        quad.drawInstanced(Primitive::TriangleStrip, instances.size());
+    }
+}
+
+int main()
+{
+    try
+    {
+        sdlmain();
+    }
+    catch (exception& ex)
+    {
+        cout << ex.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
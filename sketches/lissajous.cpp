@@ -1,14 +1,18 @@
 #include <sdl/SDLWindow.hpp>
 #include <Assets.hpp>
 #include <gl/Program.hpp>
-#include <gl/VAO.hpp>
-#include <boost/any.hpp>
+#include <gl/ProgramCache.hpp>
+#include <gl/ProgramLibrary.hpp>
+#include <gl/ProximityLines.hpp>
+#include <gl/UniformBlock.hpp>
 #include <tetra/EventStream.hpp>
 #include <tetra/AdaptiveOrtho.hpp>
+#include <tetra/AssetWatcher.hpp>
 #include <sdl/SDLEvents.hpp>
 #include <tetra/TicTocClock.hpp>
 
 #include <array>
+#include <cmath>
 #include <exception>
 
 using namespace std;
@@ -19,93 +23,42 @@ struct Vertex
     array<float, 2> pos;
 };
 
-vector<unsigned short> permute(int n)
+/**
+ * Per-frame values shared by every program through the "Frame" uniform block.
+ */
+struct alignas(16) FrameUniforms
 {
-    auto count = (n*(n-1)); // n-1'th triangle number times 2
-    auto indices = vector<unsigned short>{};
-    indices.reserve(count);
-
-    for (int i = 0; i < n-1; i++)
-    {
-        for (int j = i+1; j < n; j++)
-        {
-            indices.push_back(i);
-            indices.push_back(j);
-        }
-    }
-    return indices;
-}
-
-Program buildCobwebProgram()
-{
-    auto vertex = Shader{ShaderType::VERTEX};
-    auto fragment = Shader{ShaderType::FRAGMENT};
-    auto geometry = Shader{ShaderType::GEOMETRY};
-    fragment.compile(loadShaderSrc("lissajous.frag"));
-    vertex.compile(loadShaderSrc("lissajous.vert"));
-    geometry.compile(loadShaderSrc("lissajous.geom"));
-
-    auto program = ProgramLinker{}
-        .vertexAttributes({"vertex"})
-        .attach(vertex)
-        .attach(fragment)
-        .attach(geometry)
-        .link();
-
-    auto projLocation = program.uniformLocation("projection");
-    return program;
-}
-
-class CobwebPipeline
-{
-public:
-    CobwebPipeline(EventStream& eventStream);
-    CobwebPipeline(const CobwebPipeline&) = delete;
-    CobwebPipeline(CobwebPipeline&& from) = default;
-
-    void render();
-
-    void setVertices(const std::vector<Vertex>& vertices);
-private:
-    AdaptiveOrtho adaptiveOrtho;
-    Program program;
-    Vao vao;
-    Buffer<Vertex> vertexBuffer;
-    Buffer<unsigned short> indexBuffer;
-    GLint projLocation;
+    glm::mat4 projection;
 };
-
-CobwebPipeline::CobwebPipeline(EventStream& eventStream)
-    : program{buildCobwebProgram()}
-    , vao{Vao{}}
-    , vertexBuffer{AttribBinder<Vertex>{vao}.attrib(&Vertex::pos).bind()}
-    , indexBuffer{BindTarget::ElementArray}
-    , adaptiveOrtho{eventStream}
+STD140_MEMBER(FrameUniforms, projection);
+
+/**
+ * How quickly lines fade with length in the geometry shader.
+ */
+constexpr float FALLOFF = 15.0f;
+
+/**
+ * Lines are joined below this length, beyond which the geometry shader's fade
+ * of 0.4*exp(-falloff*d*d) is below one 8 bit step, so skipping them doesn't
+ * change the picture.
+ */
+const float CUTOFF = sqrtf(logf(0.4f*255)/FALLOFF);
+
+Program& addCobwebProgram(ProgramLibrary& programs,
+                          UniformBlock<FrameUniforms>& frameUniforms)
 {
-    projLocation = program.uniformLocation("projection");
-}
-
-void
-CobwebPipeline::setVertices(const vector<Vertex>& vertices)
-{
-    auto vbSize = vertexBuffer.size();
-    vertexBuffer.write(vertices);
-
-    // Only redo this if the number of vertices changes because the
-    // permutation scales like N^2 (technically N*(N-1))
-    if (vbSize != vertexBuffer.size())
-    {
-        indexBuffer.write(permute(vertexBuffer.size()));
-    }
-}
-
-void
-CobwebPipeline::render()
-{
-    vao.bind();
-    program.use();
-    program.uniform(projLocation, adaptiveOrtho.value());
-    indexBuffer.drawElements(Primitive::Lines);
+    // edits to any of these files rebuild the program while the sketch runs
+    return programs.add(
+        {"vertex"},
+        { {ShaderType::VERTEX, "lissajous.vert"}
+        , {ShaderType::FRAGMENT, "lissajous.frag"}
+        , {ShaderType::GEOMETRY, "lissajous.geom"}
+        },
+        [&](Program& program) {
+            frameUniforms.attach(program, "Frame");
+            program.use();
+            program.uniform(program.uniformLocation("falloff"), FALLOFF);
+        });
 }
 
 void sdlmain()
@@ -115,18 +68,29 @@ void sdlmain()
     auto window = SDLWindow::Builder{eventStream}
         .width(1000).height(750)
         .build();
+    // the cobweb streams its vertices through buffer storage
     auto gl = window.contextBuilder()
-        .majorVersion(3)
-        .minorVersion(3)
+        .majorVersion(4)
+        .minorVersion(4)
         .build();
 
     auto frameTimer = HighResTicToc{};
     auto totalTime = HighResTicToc{};
 
     auto max = 2.0f*3.1415f;
+    // the lines blend additively, so more points would brighten the cobweb
     auto count = 75;
     auto vertices = vector<Vertex>{};
-    auto cobwebPipeline = CobwebPipeline{eventStream};
+    auto adaptiveOrtho = AdaptiveOrtho{eventStream};
+    auto frameUniforms = UniformBlock<FrameUniforms>{0};
+
+    // after the first run the linked binary comes from the on-disk cache
+    auto cache = ProgramCache{};
+    auto shaderWatcher = AssetWatcher{eventStream, "shaders"};
+    auto programs = ProgramLibrary{eventStream, &cache};
+    auto cobweb = ProximityLines<Vertex>{
+        addCobwebProgram(programs, frameUniforms), &Vertex::pos, count, CUTOFF
+    };
 
     auto computeVertices = [&]() {
         auto ft = totalTime.toc();
@@ -143,8 +107,8 @@ void sdlmain()
         }
     };
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA,GL_ONE);
+    gl.state().blend(true);
+    gl.state().blendFunc(GL_SRC_ALPHA, GL_ONE);
 
     while (sdl.running())
     {
@@ -153,13 +117,14 @@ void sdlmain()
 
         cout << "frame time: " << frameTimer.ticToc() << endl;
         computeVertices();
-        cobwebPipeline.setVertices(vertices);
+        cobweb.setVertices(vertices);
+        frameUniforms.write({adaptiveOrtho.value()});
 
         auto frame = window.draw();
         glClearColor(0.0, 0.0, 0.0, 0.0);
         glClear(GL_COLOR_BUFFER_BIT);
 
-        cobwebPipeline.render();
+        cobweb.render();
     }
 }
 
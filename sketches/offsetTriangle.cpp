@@ -2,7 +2,6 @@
 #include <Assets.hpp>
 #include <gl/Program.hpp>
 #include <gl/VAO.hpp>
-#include <boost/any.hpp>
 #include <tetra/EventStream.hpp>
 #include <sdl/SDLEvents.hpp>
 #include <tetra/NDCMouse.hpp>
@@ -39,8 +38,8 @@ void sdlmain()
         .attach(fragment)
         .link();
 
-    // lookup offset location
-    auto offsetLocation = program.uniformLocation("offset");
+    // lookup offset uniform, the handle skips uploads when the value is unchanged
+    auto offset = program.uniformHandle<array<float, 2>>("offset");
 
     auto vao = Vao{};
     auto buffer = AttribBinder<Vertex>{vao}
@@ -64,7 +63,7 @@ void sdlmain()
         vao.bind();
         program.use();
         // Set the uniform value
-        program.uniform(offsetLocation, mouse.position());
+        offset.set(mouse.position());
 
         glDrawArrays(GL_TRIANGLES, 0, buffer.size());
 
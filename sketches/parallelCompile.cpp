@@ -0,0 +1,130 @@
+#include <sdl/SDLWindow.hpp>
+#include <Assets.hpp>
+#include <gl/GLState.hpp>
+#include <gl/Program.hpp>
+#include <tetra/EventStream.hpp>
+#include <tetra/TicTocClock.hpp>
+
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace tetra;
+
+/**
+ * Compare building programs one at a time with link() against submitting them
+ * all first and collecting them afterwards.
+ *
+ * To benchmark headless on Mesa's software rasterizer run something like:
+ *   LIBGL_ALWAYS_SOFTWARE=1 xvfb-run ./parallelCompile
+ */
+
+constexpr int PROGRAMS = 32;
+
+/**
+ * Build linkers for distinct variants of the lissajous program.
+ * The trailing comment changes each source so the driver's own shader cache
+ * can't hand back an earlier compile.
+ */
+vector<ProgramLinker> lissajousLinkers(const string& run)
+{
+    auto linkers = vector<ProgramLinker>(PROGRAMS);
+    for (int i = 0; i < PROGRAMS; i++)
+    {
+        const auto variant = "\n// " + run + " variant " + to_string(i) + "\n";
+        linkers[i]
+            .vertexAttributes({"vertex"})
+            .source(ShaderType::VERTEX, loadShaderSrc("lissajous.vert") + variant)
+            .source(ShaderType::FRAGMENT, loadShaderSrc("lissajous.frag") + variant)
+            .source(ShaderType::GEOMETRY, loadShaderSrc("lissajous.geom") + variant);
+    }
+    return linkers;
+}
+
+double timeSerial()
+{
+    auto linkers = lissajousLinkers("serial");
+    auto timer = HighResTicToc{};
+    auto programs = vector<Program>{};
+    for (auto& linker : linkers)
+    {
+        programs.push_back(linker.link());
+    }
+    return timer.toc();
+}
+
+double timeBatch()
+{
+    auto linkers = lissajousLinkers("batch");
+    auto timer = HighResTicToc{};
+    auto programs = linkAll(linkers);
+    return timer.toc();
+}
+
+double timePolled(long& polls)
+{
+    auto linkers = lissajousLinkers("polled");
+    auto timer = HighResTicToc{};
+
+    auto pending = vector<PendingProgram>{};
+    for (auto& linker : linkers)
+    {
+        pending.push_back(linker.submit());
+    }
+
+    // a loading screen would draw frames here instead of spinning
+    auto programs = vector<Program>{};
+    while (programs.size() < pending.size())
+    {
+        auto& next = pending[programs.size()];
+        if (next.ready())
+        {
+            programs.push_back(next.get());
+        }
+        else
+        {
+            polls += 1;
+        }
+    }
+    return timer.toc();
+}
+
+void sdlmain()
+{
+    auto eventStream = EventStream{};
+    auto sdl = SDL{eventStream};
+    auto window = SDLWindow::Builder{eventStream}
+        .title("parallel compile benchmark")
+        .build();
+    auto gl = window.contextBuilder()
+        .majorVersion(3)
+        .minorVersion(3)
+        .build();
+
+    cout << "parallel shader compile supported: "
+         << (gl.state().parallelShaderCompile() ? "yes" : "no") << endl;
+    cout << "building " << PROGRAMS << " programs" << endl;
+    cout << "link() one at a time " << timeSerial() << " seconds" << endl;
+    cout << "linkAll()            " << timeBatch() << " seconds" << endl;
+
+    long polls = 0;
+    cout << "submit() and poll    " << timePolled(polls) << " seconds, "
+         << polls << " polls before ready" << endl;
+}
+
+int main()
+{
+    try
+    {
+        sdlmain();
+    }
+    catch (exception& ex)
+    {
+        cout << ex.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include <sdl/SDLWindow.hpp>
+#include <Assets.hpp>
+#include <gl/Program.hpp>
+#include <gl/ProgramCache.hpp>
+#include <tetra/EventStream.hpp>
+#include <tetra/TicTocClock.hpp>
+
+#include <exception>
+#include <iostream>
+
+using namespace std;
+using namespace tetra;
+
+/**
+ * Compare the time it takes to build the lissajous program from source against
+ * loading it from the program binary cache.
+ *
+ * To benchmark headless on Mesa's software rasterizer run something like:
+ *   LIBGL_ALWAYS_SOFTWARE=1 xvfb-run ./programCache
+ */
+
+constexpr int PROGRAMS = 20;
+
+ProgramLinker lissajousLinker()
+{
+    auto linker = ProgramLinker{};
+    linker
+        .vertexAttributes({"vertex"})
+        .source(ShaderType::VERTEX, loadShaderSrc("lissajous.vert"))
+        .source(ShaderType::FRAGMENT, loadShaderSrc("lissajous.frag"))
+        .source(ShaderType::GEOMETRY, loadShaderSrc("lissajous.geom"));
+    return linker;
+}
+
+double timeLinks(ProgramCache* cache)
+{
+    auto timer = HighResTicToc{};
+    for (int i = 0; i < PROGRAMS; i++)
+    {
+        auto linker = lissajousLinker();
+        if (cache != nullptr)
+        {
+            linker.cache(*cache);
+        }
+        auto program = linker.link();
+    }
+    glFinish();
+    return timer.toc();
+}
+
+void sdlmain()
+{
+    auto eventStream = EventStream{};
+    auto sdl = SDL{eventStream};
+    auto window = SDLWindow::Builder{eventStream}
+        .title("program cache benchmark")
+        .build();
+    auto gl = window.contextBuilder()
+        .majorVersion(3)
+        .minorVersion(3)
+        .build();
+
+    auto cache = ProgramCache{};
+
+    cout << "linking " << PROGRAMS << " programs" << endl;
+    cout << "cold (compile from source) " << timeLinks(nullptr) << " seconds" << endl;
+
+    // the first cached link stores the binary for the rest
+    lissajousLinker().cache(cache).link();
+    cout << "warm (program binary)      " << timeLinks(&cache) << " seconds" << endl;
+}
+
+int main()
+{
+    try
+    {
+        sdlmain();
+    }
+    catch (exception& ex)
+    {
+        cout << ex.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
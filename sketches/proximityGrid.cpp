@@ -0,0 +1,103 @@
+#include <tetra/ProximityGrid.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace tetra;
+
+/**
+ * Check ProximityGrid against comparing every pair, including the inputs that
+ * push the grid to its limits: collinear points, whose bounding box has no
+ * area, and cutoffs far smaller than the spacing of the points.
+ * This is CPU only, no GL context is created.
+ */
+
+using Position = ProximityGrid::Position;
+
+int failures = 0;
+
+vector<pair<int, int>> bruteForce(const vector<Position>& points, float cutoff)
+{
+    auto pairs = vector<pair<int, int>>{};
+    for (int i = 0; i < (int)points.size(); i++)
+    {
+        for (int j = i + 1; j < (int)points.size(); j++)
+        {
+            const float x = points[i][0] - points[j][0];
+            const float y = points[i][1] - points[j][1];
+            if (x*x + y*y < cutoff*cutoff)
+            {
+                pairs.emplace_back(i, j);
+            }
+        }
+    }
+    return pairs;
+}
+
+void check(const string& name, const vector<Position>& points, float cutoff)
+{
+    auto grid = ProximityGrid{};
+    grid.build(points, cutoff);
+
+    auto found = vector<pair<int, int>>{};
+    grid.forEachPair([&](int i, int j) {
+        found.emplace_back(min(i, j), max(i, j));
+    });
+    sort(begin(found), end(found));
+
+    const auto expected = bruteForce(points, cutoff);
+    const bool passed = found == expected;
+    cout << (passed ? "PASS " : "FAIL ") << name << endl;
+    if (!passed)
+    {
+        cout << "    found " << found.size() << " pairs, expected "
+             << expected.size() << endl;
+    }
+    failures += passed ? 0 : 1;
+}
+
+int main()
+{
+    auto random = mt19937{1234};
+    auto unit = uniform_real_distribution<float>{-1.0f, 1.0f};
+
+    auto scattered = vector<Position>(2000);
+    for (auto& point : scattered)
+    {
+        point = {unit(random), unit(random)};
+    }
+
+    auto horizontal = vector<Position>{};
+    auto vertical = vector<Position>{};
+    auto diagonal = vector<Position>{};
+    for (int i = 0; i < 2000; i++)
+    {
+        const float t = unit(random);
+        horizontal.push_back({t, 0.5f});
+        vertical.push_back({-0.25f, t});
+        diagonal.push_back({t, t});
+    }
+
+    check("no points", {}, 0.1f);
+    check("one point", {{0.0f, 0.0f}}, 0.1f);
+    check("coincident points", vector<Position>(50, Position{0.3f, 0.3f}), 0.1f);
+    check("coincident points with no cutoff", vector<Position>(50, Position{0.3f, 0.3f}), 0.0f);
+    check("scattered", scattered, 0.05f);
+    check("scattered, cutoff wider than the points", scattered, 3.0f);
+    check("scattered, tiny cutoff", scattered, 1e-5f);
+    check("scattered, tinier cutoff", scattered, 1e-7f);
+    check("horizontal line", horizontal, 0.01f);
+    check("horizontal line, tiny cutoff", horizontal, 1e-5f);
+    check("vertical line, tinier cutoff", vertical, 1e-7f);
+    check("diagonal line, tiny cutoff", diagonal, 1e-5f);
+    check("far apart points", {{-3e38f, -3e38f}, {3e38f, 3e38f}, {3e38f, 3e38f}}, 1.0f);
+    check("infinite point", {{0.0f, 0.0f}, {INFINITY, 0.0f}, {0.0f, 0.0f}}, 1.0f);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+#include <sdl/SDLWindow.hpp>
+#include <Assets.hpp>
+#include <gl/Program.hpp>
+#include <gl/RenderQueue.hpp>
+#include <gl/VAO.hpp>
+#include <tetra/TicTocClock.hpp>
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace tetra;
+
+/**
+ * Submit thousands of draws spread over several programs, vaos and blend
+ * states in a random order every frame, then compare issuing them in
+ * submission order against RenderQueue's sorted order.
+ *
+ * To benchmark headless on Mesa's software rasterizer run something like:
+ *   LIBGL_ALWAYS_SOFTWARE=1 xvfb-run ./renderQueue
+ */
+
+struct Vertex
+{
+    array<float, 2> pos;
+};
+
+constexpr int PROGRAMS = 8;
+constexpr int VAOS = 16;
+constexpr int DRAWS = 5000;
+constexpr int FRAMES = 200;
+
+struct Mesh
+{
+    Vao vao;
+    Buffer<Vertex> vertices;
+};
+
+Mesh triangle(float x, float y)
+{
+    auto vao = Vao{};
+    auto vertices = AttribBinder<Vertex>{vao}.attrib(&Vertex::pos).bind();
+    vertices.write({ Vertex{{x, y}}
+                   , Vertex{{x + 0.05f, y}}
+                   , Vertex{{x, y + 0.05f}}
+                   });
+    return Mesh{move(vao), move(vertices)};
+}
+
+/**
+ * Draw every frame's keys through the queue, shuffled before each submit.
+ */
+double bench(SDLWindow& window, RenderQueue& queue, vector<uint64_t> keys, bool sort)
+{
+    auto random = mt19937{42};
+    auto total = RenderQueue::Stats{};
+
+    auto timer = HighResTicToc{};
+    for (int frame = 0; frame < FRAMES; frame++)
+    {
+        shuffle(begin(keys), end(keys), random);
+
+        auto drawFrame = window.draw();
+        glClear(GL_COLOR_BUFFER_BIT);
+        for (auto key : keys)
+        {
+            queue.submit(key, DrawCall{Primitive::Triangles, 0, 3});
+        }
+        auto stats = queue.flush(sort);
+
+        total.draws += stats.draws;
+        total.programChanges += stats.programChanges;
+        total.vaoChanges += stats.vaoChanges;
+        total.blendChanges += stats.blendChanges;
+    }
+    glFinish();
+    auto seconds = timer.toc();
+
+    cout << (sort ? "sorted    " : "submitted ")
+         << seconds * 1000 / FRAMES << " ms/frame, per frame "
+         << total.programChanges / FRAMES << " program, "
+         << total.vaoChanges / FRAMES << " vao and "
+         << total.blendChanges / FRAMES << " blend changes for "
+         << total.draws / FRAMES << " draws" << endl;
+    return seconds;
+}
+
+void sdlmain()
+{
+    auto eventStream = EventStream{};
+    auto sdl = SDL{eventStream};
+    auto window = SDLWindow::Builder{eventStream}
+        .title("render queue benchmark")
+        .build();
+    auto gl = window.contextBuilder()
+        .majorVersion(3)
+        .minorVersion(3)
+        .build();
+
+    auto programs = vector<Program>{};
+    for (int i = 0; i < PROGRAMS; i++)
+    {
+        programs.push_back(ProgramLinker{}
+            .vertexAttributes({"vertex"})
+            .source(ShaderType::VERTEX, loadShaderSrc("identity.vert"))
+            .source(ShaderType::FRAGMENT, loadShaderSrc("identity.frag"))
+            .link());
+    }
+
+    auto meshes = vector<Mesh>{};
+    for (int i = 0; i < VAOS; i++)
+    {
+        meshes.push_back(triangle(-0.9f + 0.1f*i, -0.9f + 0.1f*i));
+    }
+
+    auto queue = RenderQueue{};
+    auto blends = array<int, 2>{
+        0, queue.blendState({true, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA})
+    };
+
+    auto random = mt19937{7};
+    auto keys = vector<uint64_t>{};
+    for (int i = 0; i < DRAWS; i++)
+    {
+        keys.push_back(queue.key(
+            random() % 2,
+            programs[random() % PROGRAMS],
+            meshes[random() % VAOS].vao,
+            blends[random() % 2],
+            (random() % 1000) / 1000.0f
+        ));
+    }
+
+    cout << FRAMES << " frames of " << DRAWS << " draws over " << PROGRAMS
+         << " programs and " << VAOS << " vaos" << endl;
+    auto submitted = bench(window, queue, keys, false);
+    auto sorted = bench(window, queue, keys, true);
+    cout << "sorting is " << submitted / sorted << "x faster" << endl;
+}
+
+int main()
+{
+    try
+    {
+        sdlmain();
+    }
+    catch (exception& ex)
+    {
+        cout << ex.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include <sdl/SDLWindow.hpp>
+#include <Assets.hpp>
+#include <gl/Program.hpp>
+#include <gl/VAO.hpp>
+#include <gl/StreamingBuffer.hpp>
+#include <tetra/EventStream.hpp>
+#include <tetra/TicTocClock.hpp>
+
+#include <array>
+#include <exception>
+#include <iostream>
+
+using namespace std;
+using namespace tetra;
+
+/**
+ * Compare per-frame vertex uploads through Buffer::write, both orphaning the
+ * store every frame (glBufferData then glBufferSubData) and updating it in
+ * place (glBufferSubData only), with StreamingBuffer (persistently mapped,
+ * fenced regions).
+ *
+ * To benchmark headless on Mesa's software rasterizer run something like:
+ *   LIBGL_ALWAYS_SOFTWARE=1 xvfb-run ./streamingBenchmark
+ */
+
+struct Vertex
+{
+    array<float, 2> pos;
+};
+
+constexpr int FRAMES = 500;
+constexpr int VERTICES = 50000;
+
+Program buildProgram()
+{
+    auto vertex = Shader{ShaderType::VERTEX};
+    auto fragment = Shader{ShaderType::FRAGMENT};
+    fragment.compile(loadShaderSrc("identity.frag"));
+    vertex.compile(loadShaderSrc("identity.vert"));
+
+    return ProgramLinker{}
+        .vertexAttributes({"vertex"})
+        .attach(vertex)
+        .attach(fragment)
+        .link();
+}
+
+void fillVertices(vector<Vertex>& vertices, int frame)
+{
+    for (int i = 0; i < VERTICES; i++)
+    {
+        float t = (float)(i + frame)/VERTICES;
+        vertices[i] = Vertex{{t, 1.0f - t}};
+    }
+}
+
+/**
+ * Upload with Buffer::write. With orphan set the usage hint alternates each
+ * frame, which makes write() reallocate the store before uploading.
+ */
+double benchWrite(SDLWindow& window, Program& program, vector<Vertex>& vertices, bool orphan)
+{
+    auto vao = Vao{};
+    auto buffer = AttribBinder<Vertex>{vao}.attrib(&Vertex::pos).bind();
+
+    auto timer = HighResTicToc{};
+    for (int frame = 0; frame < FRAMES; frame++)
+    {
+        fillVertices(vertices, frame);
+        const bool odd = orphan && frame % 2 == 1;
+        buffer.write(vertices, odd ? UsageHint::DynamicDraw : UsageHint::StreamDraw);
+
+        auto drawFrame = window.draw();
+        glClear(GL_COLOR_BUFFER_BIT);
+        vao.bind();
+        program.use();
+        buffer.draw(Primitive::Points);
+    }
+    glFinish();
+    return timer.toc();
+}
+
+double benchStreaming(SDLWindow& window, Program& program, vector<Vertex>& vertices)
+{
+    auto vao = Vao{};
+    auto buffer = StreamingBuffer<Vertex>{
+        AttribBinder<Vertex>{vao}.attrib(&Vertex::pos).bind(), VERTICES
+    };
+
+    auto timer = HighResTicToc{};
+    for (int frame = 0; frame < FRAMES; frame++)
+    {
+        fillVertices(vertices, frame);
+        buffer.write(vertices);
+
+        auto drawFrame = window.draw();
+        glClear(GL_COLOR_BUFFER_BIT);
+        vao.bind();
+        program.use();
+        buffer.draw(Primitive::Points);
+    }
+    glFinish();
+    return timer.toc();
+}
+
+void sdlmain()
+{
+    auto eventStream = EventStream{};
+    auto sdl = SDL{eventStream};
+    auto window = SDLWindow::Builder{eventStream}
+        .title("streaming benchmark")
+        .build();
+    auto gl = window.contextBuilder()
+        .majorVersion(4)
+        .minorVersion(5)
+        .build();
+
+    auto program = buildProgram();
+    auto vertices = vector<Vertex>(VERTICES);
+
+    cout << FRAMES << " frames of " << VERTICES << " vertices" << endl;
+    cout << "Buffer::write orphaned " << benchWrite(window, program, vertices, true)
+         << " seconds" << endl;
+    cout << "Buffer::write in place " << benchWrite(window, program, vertices, false)
+         << " seconds" << endl;
+    cout << "StreamingBuffer::write " << benchStreaming(window, program, vertices)
+         << " seconds" << endl;
+}
+
+int main()
+{
+    try
+    {
+        sdlmain();
+    }
+    catch (exception& ex)
+    {
+        cout << ex.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,172 @@
+#include <AssetArchive.hpp>
+#include <Assets.hpp>
+#include <MappedFile.hpp>
+#include <tetra/Fnv1a.hpp>
+
+#ifdef TETRA_LZ4
+#include <lz4.h>
+#endif
+
+#include <ftw.h>
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace tetra;
+using namespace tetra::archive;
+
+/**
+ * Pack every file under an asset directory into a single archive which
+ * AssetCache can serve assets from. See AssetArchive.hpp for the layout.
+ *
+ * USAGE:
+ *      packAssets <asset directory> <archive> [--lz4]
+ *
+ * With --lz4 each file is stored compressed if that makes it smaller.
+ */
+
+vector<string> files;
+
+int collect(const char* path, const struct stat*, int type, struct FTW*)
+{
+    if (type == FTW_F)
+    {
+        files.push_back(path);
+    }
+    return 0;
+}
+
+/**
+ * The bytes stored in the archive for one file.
+ */
+struct Packed
+{
+    string name;
+    unique_ptr<MappedFile> file;
+    string compressed;
+    IndexEntry index;
+
+    string_view stored() const
+    {
+        return (index.flags & LZ4) != 0 ? string_view{compressed} : file->data();
+    }
+};
+
+void compress(Packed& packed)
+{
+#ifdef TETRA_LZ4
+    const auto data = packed.file->data();
+    packed.compressed.resize(LZ4_compressBound(data.size()));
+    const auto size = LZ4_compress_default(
+        data.data(), &packed.compressed[0], data.size(), packed.compressed.size()
+    );
+    if (size > 0 && (size_t)size < data.size())
+    {
+        packed.compressed.resize(size);
+        packed.index.flags |= LZ4;
+        packed.index.storedSize = size;
+    }
+#else
+    (void)packed;
+    throw runtime_error{"packAssets was built without LZ4 support"};
+#endif
+}
+
+uint64_t aligned(uint64_t offset)
+{
+    return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+void pack(const string& root, const string& archive, bool lz4)
+{
+    if (nftw(root.c_str(), collect, 16, FTW_PHYS) != 0)
+    {
+        throw FailedToLoadAsset{"assets", root, "the directory could not be read"};
+    }
+    sort(begin(files), end(files));
+
+    auto packed = vector<Packed>{};
+    auto names = string{};
+    for (const auto& path : files)
+    {
+        auto entry = Packed{path.substr(root.size() + 1), nullptr, string{}, IndexEntry{}};
+        entry.file.reset(new MappedFile{entry.name, path});
+
+        const auto data = entry.file->data();
+        entry.index.size = data.size();
+        entry.index.storedSize = data.size();
+        entry.index.hash = Fnv1a{}.add(data).value();
+        entry.index.nameOffset = names.size();
+        entry.index.nameLength = entry.name.size();
+        names += entry.name;
+        if (lz4)
+        {
+            compress(entry);
+        }
+        packed.push_back(move(entry));
+    }
+
+    auto offset = aligned(sizeof(Header) + packed.size() * sizeof(IndexEntry) + names.size());
+    for (auto& entry : packed)
+    {
+        entry.index.offset = offset;
+        offset = aligned(offset + entry.index.storedSize);
+    }
+
+    auto out = ofstream{archive, ios::binary | ios::trunc};
+    auto header = Header{{}, VERSION, (uint32_t)packed.size(), (uint32_t)names.size()};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    out.write((const char*)&header, sizeof(header));
+    for (const auto& entry : packed)
+    {
+        out.write((const char*)&entry.index, sizeof(entry.index));
+    }
+    out.write(names.data(), names.size());
+
+    for (const auto& entry : packed)
+    {
+        const auto padding = string(entry.index.offset - out.tellp(), '\0');
+        out.write(padding.data(), padding.size());
+        out.write(entry.stored().data(), entry.stored().size());
+    }
+
+    if (!out.good())
+    {
+        throw FailedToLoadAsset{"asset archive", archive, "it could not be written"};
+    }
+    cout << "packed " << packed.size() << " assets into " << archive
+         << " (" << out.tellp() << " bytes)" << endl;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        cout << "usage: packAssets <asset directory> <archive> [--lz4]" << endl;
+        return 1;
+    }
+
+    try
+    {
+        auto root = string{argv[1]};
+        while (root.size() > 1 && root.back() == '/')
+        {
+            root.pop_back();
+        }
+        pack(root, argv[2], argc > 3 && string{argv[3]} == "--lz4");
+    }
+    catch (exception& ex)
+    {
+        cout << ex.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}